@@ -0,0 +1,86 @@
+/*
+ * File: FixedTrig.h
+ *
+ * Description:
+ * This file declares the FixedTrig namespace, a small table-driven
+ * fixed-point trigonometry toolkit. Angles are binary angles (a full turn
+ * is 65536, so an int16_t reading is a wrapped Q15 fraction of π) and
+ * results are Q15 values, which keeps sin/cos off the floating point
+ * library on the 32U4.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+#include <avr/pgmspace.h>
+
+namespace FixedTrig {
+
+    typedef uint16_t BinaryAngle; // Full turn == 65536; wraps for free.
+
+    // Binary angle constants.
+    const BinaryAngle ANGLE_90 = 0x4000;
+    const BinaryAngle ANGLE_180 = 0x8000;
+
+    // Number of table steps in a quarter turn (table holds one extra entry).
+    const uint16_t QUARTER_STEPS = 256;
+
+    // Quarter-wave sine table, sin(i * 90° / 256) in Q15 for i = 0..256.
+    extern const int16_t quarterSine[QUARTER_STEPS + 1] PROGMEM;
+
+    /*
+     * Returns sin(angle) in Q15, linearly interpolated between table entries.
+     */
+    inline int16_t sinQ15(BinaryAngle angle) {
+        uint16_t folded = angle & 0x7FFF;     // Fold the negative half onto the positive.
+        if (folded > ANGLE_90) {
+            folded = ANGLE_180 - folded;      // Mirror the second quadrant onto the first.
+        }
+
+        const uint8_t fraction = folded & 0x3F;
+        const uint16_t index = folded >> 6;   // 0..256
+
+        int16_t value = pgm_read_word(&quarterSine[index]);
+        if (fraction != 0) {
+            const int16_t next = pgm_read_word(&quarterSine[index + 1]);
+            value += ((next - value) * fraction) >> 6;
+        }
+
+        return (angle & ANGLE_180) ? -value : value;
+    }
+
+    /*
+     * Returns cos(angle) in Q15.
+     */
+    inline int16_t cosQ15(BinaryAngle angle) {
+        return sinQ15(angle + ANGLE_90);
+    }
+
+    /*
+     * Multiplies a 32-bit value by a Q15 factor and rounds the result,
+     * without needing a 64-bit product.
+     */
+    inline int32_t mulQ15(int32_t value, int16_t factor) {
+        const int32_t high = value >> 15;     // Arithmetic shift keeps the sign.
+        const int32_t low = value & 0x7FFF;
+        return high * factor + ((low * factor + 0x4000) >> 15);
+    }
+
+    /*
+     * Converts a binary angle to radians in [-π, π), for display only.
+     */
+    inline double toRadians(BinaryAngle angle) {
+        return static_cast<int16_t>(angle) * (M_PI / 32768.0);
+    }
+
+    /*
+     * Converts radians to a binary angle.
+     */
+    inline BinaryAngle fromRadians(double radians) {
+        return static_cast<BinaryAngle>(static_cast<int32_t>(lround(radians * (32768.0 / M_PI))));
+    }
+}
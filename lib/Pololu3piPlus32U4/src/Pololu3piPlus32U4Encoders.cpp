@@ -2,6 +2,7 @@
 
 #include <Pololu3piPlus32U4Encoders.h>
 #include <FastGPIO.h>
+#include <FixedTrig.h>
 #include <avr/interrupt.h>
 #include <Arduino.h>
 
@@ -26,12 +27,82 @@ static volatile bool errorRight;
 static volatile uint16_t countLeft;
 static volatile uint16_t countRight;
 
+// Edge timing, see getEdgeSnapshot().  Timer3 counts at 2 MHz and the
+// overflow count extends it to 32 bits for the edge timer and to 48 bits
+// for getMicros().
+static volatile uint32_t timerOverflows;
+static volatile uint32_t lastEdgeLeft;
+static volatile uint32_t lastEdgeRight;
+static volatile uint32_t periodLeft;
+static volatile uint32_t periodRight;
+
+ISR(TIMER3_OVF_vect)
+{
+    timerOverflows++;
+}
+
+// Returns the extended timer value.  Must be called with interrupts disabled.
+static inline uint32_t readTimer()
+{
+    uint16_t low = TCNT3;
+    uint16_t high = (uint16_t)timerOverflows;
+
+    // An overflow that happened after interrupts were disabled has not been
+    // counted yet; a small low half means it happened before we read TCNT3.
+    if ((TIFR3 & (1 << TOV3)) && low < 0x8000)
+    {
+        high++;
+    }
+    return ((uint32_t)high << 16) | low;
+}
+
+// Per-tick pose, see enablePoseTracking().
+static int32_t poseHalfStep;
+static volatile uint32_t poseHeading;
+static volatile int32_t poseX;
+static volatile int32_t poseY;
+
+// Advances the pose by one tick.  The heading step is applied in two halves
+// so the displacement is taken along the heading in the middle of the tick.
+static inline void poseTick(int8_t direction, int32_t halfStep)
+{
+    uint32_t heading = poseHeading + halfStep;
+    uint16_t angle = heading >> 16;
+    int16_t c = FixedTrig::cosQ15(angle);
+    int16_t s = FixedTrig::sinQ15(angle);
+    if (direction > 0)
+    {
+        poseX += c;
+        poseY += s;
+    }
+    else
+    {
+        poseX -= c;
+        poseY -= s;
+    }
+    poseHeading = heading + halfStep;
+}
+
 ISR(PCINT0_vect)
 {
     bool newLeftB = FastGPIO::Pin<LEFT_B>::isInputHigh();
     bool newLeftA = FastGPIO::Pin<LEFT_XOR>::isInputHigh() ^ newLeftB;
 
-    countLeft += (newLeftA ^ lastLeftB) - (lastLeftA ^ newLeftB);
+    int8_t direction = (newLeftA ^ lastLeftB) - (lastLeftA ^ newLeftB);
+    countLeft += direction;
+
+    if (direction != 0)
+    {
+        uint32_t now = readTimer();
+        periodLeft = now - lastEdgeLeft;
+        lastEdgeLeft = now;
+    }
+
+    if (direction != 0 && poseHalfStep != 0)
+    {
+        // Left wheel forward turns clockwise.
+        poseTick(direction, direction > 0 ? -poseHalfStep : poseHalfStep);
+    }
 
     if((lastLeftA ^ newLeftA) & (lastLeftB ^ newLeftB))
     {
@@ -47,7 +118,21 @@ static void rightISR()
     bool newRightB = FastGPIO::Pin<RIGHT_B>::isInputHigh();
     bool newRightA = FastGPIO::Pin<RIGHT_XOR>::isInputHigh() ^ newRightB;
 
-    countRight += (newRightA ^ lastRightB) - (lastRightA ^ newRightB);
+    int8_t direction = (newRightA ^ lastRightB) - (lastRightA ^ newRightB);
+    countRight += direction;
+
+    if (direction != 0)
+    {
+        uint32_t now = readTimer();
+        periodRight = now - lastEdgeRight;
+        lastEdgeRight = now;
+    }
+
+    if (direction != 0 && poseHalfStep != 0)
+    {
+        // Right wheel forward turns counter-clockwise.
+        poseTick(direction, direction > 0 ? poseHalfStep : -poseHalfStep);
+    }
 
     if((lastRightA ^ newRightA) & (lastRightB ^ newRightB))
     {
@@ -77,6 +162,16 @@ void Encoders::init2()
     // compatible with other code that uses attachInterrupt.
     attachInterrupt(4, rightISR, CHANGE);
 
+    // Run Timer3 as a free-running counter for edge timestamps: normal mode,
+    // clock/8 = 2 MHz, overflow interrupt every 32.768 ms.  This overrides
+    // the 8-bit PWM mode that the Arduino core puts Timer3 in.
+    TCCR3A = 0;
+    TCCR3B = (1 << CS31);
+    TCNT3 = 0;
+    TIFR3 = (1 << TOV3);
+    TIMSK3 = (1 << TOIE3);
+    timerOverflows = 0;
+
     // Initialize the variables.  It's good to do this after enabling the
     // interrupts in case the interrupts fired by accident as we were enabling
     // them.
@@ -84,11 +179,15 @@ void Encoders::init2()
     lastLeftA = FastGPIO::Pin<LEFT_XOR>::isInputHigh() ^ lastLeftB;
     countLeft = 0;
     errorLeft = 0;
+    lastEdgeLeft = 0;
+    periodLeft = 0xFFFFFFFF;
 
     lastRightB = FastGPIO::Pin<RIGHT_B>::isInputHigh();
     lastRightA = FastGPIO::Pin<RIGHT_XOR>::isInputHigh() ^ lastRightB;
     countRight = 0;
     errorRight = 0;
+    lastEdgeRight = 0;
+    periodRight = 0xFFFFFFFF;
 }
 
 bool Encoders::flip;
@@ -140,6 +239,95 @@ int16_t Encoders::getCountsAndResetRight()
     return flip ? -counts : counts;
 }
 
+uint32_t Encoders::getTimerTicks()
+{
+    init();
+
+    uint8_t oldSREG = SREG;
+    cli();
+    uint32_t now = readTimer();
+    SREG = oldSREG;
+    return now;
+}
+
+uint32_t Encoders::getMicros()
+{
+    init();
+
+    uint8_t oldSREG = SREG;
+    cli();
+    uint16_t low = TCNT3;
+    uint32_t overflows = timerOverflows;
+    bool overflowPending = TIFR3 & (1 << TOV3);
+    SREG = oldSREG;
+    return timerToMicros(overflows, low, overflowPending);
+}
+
+void Encoders::getEdgeSnapshot(EdgeSnapshot & snapshot)
+{
+    init();
+
+    uint8_t oldSREG = SREG;
+    cli();
+    int16_t left = countLeft;
+    int16_t right = countRight;
+    snapshot.lastEdgeLeft = lastEdgeLeft;
+    snapshot.lastEdgeRight = lastEdgeRight;
+    snapshot.periodLeft = periodLeft;
+    snapshot.periodRight = periodRight;
+    snapshot.now = readTimer();
+    SREG = oldSREG;
+
+    snapshot.countLeft = flip ? -left : left;
+    snapshot.countRight = flip ? -right : right;
+}
+
+void Encoders::enablePoseTracking(uint32_t headingPerTick)
+{
+    init();
+
+    cli();
+    poseHalfStep = headingPerTick >> 1;
+    poseHeading = 0;
+    poseX = 0;
+    poseY = 0;
+    sei();
+}
+
+void Encoders::getPoseSnapshot(PoseSnapshot & snapshot)
+{
+    init();
+
+    uint8_t oldSREG = SREG;
+    cli();
+    int16_t left = countLeft;
+    int16_t right = countRight;
+    uint32_t heading = poseHeading;
+    int32_t x = poseX;
+    int32_t y = poseY;
+    poseX = 0;
+    poseY = 0;
+    SREG = oldSREG;
+
+    if (flip)
+    {
+        // Both wheels reversed: the turn direction and forward axis flip.
+        snapshot.countLeft = -left;
+        snapshot.countRight = -right;
+        snapshot.heading = -heading;
+        snapshot.displacementX = -x;
+        snapshot.displacementY = y;
+    }
+    else
+    {
+        snapshot.countLeft = left;
+        snapshot.countRight = right;
+        snapshot.heading = heading;
+        snapshot.displacementX = x;
+        snapshot.displacementY = y;
+    }
+}
+
 bool Encoders::checkErrorLeft()
 {
     init();
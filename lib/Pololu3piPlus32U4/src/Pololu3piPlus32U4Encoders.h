@@ -25,6 +25,10 @@ namespace Pololu3piPlus32U4
 /// [attachInterrupt()](http://arduino.cc/en/Reference/attachInterrupt), so
 /// there will be a compile-time conflict with any other code that defines an
 /// ISR for an external interrupt directly instead of using attachInterrupt().
+///
+/// To timestamp encoder edges, this class runs Timer3 as a free-running
+/// counter at 2 MHz and defines an ISR for TIMER3_OVF_vect, so Timer3 PWM
+/// (analogWrite() on pin 5) is not available.
 class Encoders
 {
 
@@ -107,6 +111,126 @@ public:
     /// \sa checkErrorLeft()
     static bool checkErrorRight();
 
+    /// \brief A consistent view of the encoder counts and the per-tick pose.
+    ///
+    /// \sa getPoseSnapshot()
+    struct PoseSnapshot
+    {
+        /// Left encoder count, as returned by getCountsLeft().
+        int16_t countLeft;
+
+        /// Right encoder count, as returned by getCountsRight().
+        int16_t countRight;
+
+        /// Heading accumulated since enablePoseTracking(), where 2^32
+        /// represents a full counter-clockwise turn.
+        uint32_t heading;
+
+        /// Forward displacement along the x axis since the previous
+        /// snapshot, in units of half a tick times 2^-15.
+        int32_t displacementX;
+
+        /// Displacement along the y axis (counter-clockwise positive) since
+        /// the previous snapshot, in units of half a tick times 2^-15.
+        int32_t displacementY;
+    };
+
+    /// Number of timer ticks per second used by the edge timestamps.
+    static const uint32_t timerTicksPerSecond = 2000000;
+
+    /// \brief A consistent view of both encoders and their edge timing.
+    ///
+    /// \sa getEdgeSnapshot()
+    struct EdgeSnapshot
+    {
+        /// Left encoder count, as returned by getCountsLeft().
+        int16_t countLeft;
+
+        /// Right encoder count, as returned by getCountsRight().
+        int16_t countRight;
+
+        /// Timer value at the most recent left encoder edge.
+        uint32_t lastEdgeLeft;
+
+        /// Timer value at the most recent right encoder edge.
+        uint32_t lastEdgeRight;
+
+        /// Timer ticks between the two most recent left encoder edges.
+        uint32_t periodLeft;
+
+        /// Timer ticks between the two most recent right encoder edges.
+        uint32_t periodRight;
+
+        /// Timer value when the snapshot was taken.
+        uint32_t now;
+    };
+
+    /// \brief Returns the free-running edge timer, in units of
+    /// 1/timerTicksPerSecond seconds.
+    ///
+    /// The value is 32 bits wide (Timer3 extended by its overflow count), so
+    /// it wraps around after about 35 minutes.
+    static uint32_t getTimerTicks();
+
+    /// \brief Returns a monotonic microsecond clock running off the same
+    /// timer.
+    ///
+    /// The value is the 2 MHz timer extended by a 32-bit overflow count and
+    /// divided by two, so it has 1 us resolution, no jumps, and wraps
+    /// cleanly at 2^32 us (about 71.6 minutes): compare times by
+    /// subtracting them.  Reading it takes a short critical section.
+    static uint32_t getMicros();
+
+    /// \brief Combines a raw timer reading into microseconds, as
+    /// getMicros() does.
+    ///
+    /// \param overflows The overflow count read with interrupts disabled.
+    /// \param low The timer count (TCNT3) read in the same critical section.
+    /// \param overflowPending True if the overflow flag was set, i.e. an
+    /// overflow happened that has not been counted yet.  It belongs to the
+    /// reading only if \p low is small, since the flag may also have been
+    /// set after TCNT3 was read.
+    static uint32_t timerToMicros(uint32_t overflows, uint16_t low, bool overflowPending)
+    {
+        if (overflowPending && low < 0x8000)
+        {
+            overflows++;
+        }
+        return (overflows << 15) | (low >> 1);
+    }
+
+    /// \brief Reads both counts and the edge timestamps in one critical
+    /// section.
+    ///
+    /// This is cheaper than calling getCountsLeft() and getCountsRight()
+    /// separately, and the two wheels are guaranteed to be sampled at the
+    /// same instant.  Wheel speed can be derived from the inter-edge period
+    /// at low speed, or from counts over edge time at high speed.
+    ///
+    /// \param snapshot Receives the counts and timing.
+    static void getEdgeSnapshot(EdgeSnapshot & snapshot);
+
+    /// \brief Enables per-tick pose tracking in the encoder ISRs.
+    ///
+    /// Once enabled, every encoder tick advances the heading by
+    /// \p headingPerTick (right wheel forward turns counter-clockwise) and
+    /// adds a half-tick step along the current heading, using a table-based
+    /// sine.  This makes the pose independent of how often it is read.
+    ///
+    /// Calling this function also resets the heading and the displacement.
+    ///
+    /// \param headingPerTick Heading change caused by one tick of a single
+    /// wheel, where 2^32 represents a full turn.  Pass 0 to disable tracking.
+    static void enablePoseTracking(uint32_t headingPerTick);
+
+    /// \brief Reads the counts and the per-tick pose in one critical section.
+    ///
+    /// The displacement is cleared after it is read, so it will not overflow
+    /// as long as this is called at least once every few metres.
+    ///
+    /// \param snapshot Receives the counts, heading and displacement.
+    static void getPoseSnapshot(PoseSnapshot & snapshot);
+
 private:
 
     static void init2();
@@ -0,0 +1,225 @@
+/*
+ * File: event_benchmark.cpp
+ *
+ * Description:
+ * Host benchmark of the EventManager backends on a fixed mission event
+ * mix. One build times the backend selected by BENCH_LINKED_LIST (0: the
+ * FIFO rings, 1: the TaskPriorityLinkedList) against `ScanEventManager`,
+ * a copy of the original EventManager that scans every event from a
+ * cursor on each next().
+ *
+ * The mix is a seeded pseudo-random run of frames that mostly fire
+ * nothing. Some fire one sign event. A few fire a burst with an urgent
+ * event, and the SlowDown callback fires Reached5cm, as the mission does.
+ * Every frame then dispatches the way main.cpp does: dispatch() with
+ * EVENT_DISPATCH_BUDGET for the current manager, `while (next())` for
+ * the scan. Separate rows time a dispatch with nothing pending (most
+ * frames of a run) and bursts of 1 to NUMBER_OF_EVENTS pending events.
+ *
+ *     research/event_benchmark.sh      builds and runs both backends
+ *
+ * Times are host nanoseconds, a proxy for AVR cycles: the ratios carry
+ * over, the absolute numbers do not.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include <chrono>
+#include <cstdio>
+#include "RATS.h"
+
+#undef EVENT_LINKED_LIST
+#define EVENT_LINKED_LIST BENCH_LINKED_LIST
+#undef EVENT_TRACE
+#define EVENT_TRACE 0
+
+#include "EventManager.h"
+
+/*
+ * The original EventManager: a fired flag per event, scanned from a
+ * cursor on every next().
+ */
+class ScanEventManager {
+    struct Promise {
+        bool fired = false;
+        Callback callback = nullptr;
+    };
+
+    struct Promise callbackList[NUMBER_OF_EVENTS];
+    int last = 0;
+
+public:
+    void fireEvent(Event event) {
+        callbackList[event].fired = true;
+    }
+
+    void setupListener(Event event, Callback callback) {
+        callbackList[event].callback = callback;
+    }
+
+    bool next() {
+        for (int i = last; i < NUMBER_OF_EVENTS; i++) {
+            if (callbackList[i].fired) {
+                callbackList[i].fired = false;
+                if (callbackList[i].callback != nullptr) {
+                    callbackList[i].callback(Event(i));
+                }
+                last += 1;
+                return true;
+            }
+        }
+        last = 0;
+        return false;
+    }
+};
+
+static const uint32_t FRAMES = 10000;     // 100 s of game loop.
+static const uint8_t MAX_FIRES = 4;       // Most events fired in one frame.
+static const int RUNS = 200;
+
+/*
+ * Events fired at the start of each frame, NUMBER_OF_EVENTS terminated.
+ */
+static uint8_t mix[FRAMES][MAX_FIRES + 1];
+static uint32_t mixEvents = 0;
+
+static volatile uint32_t handled = 0;
+static ScanEventManager *scanManager = nullptr;
+static EventManager *manager = nullptr;
+
+static void count(Event event) {
+    handled += event;
+}
+
+static void scanSlowDown(Event event) {
+    count(event);
+    scanManager->fireEvent(Reached5cm);
+}
+
+static void slowDown(Event event) {
+    count(event);
+    manager->fireEvent(Reached5cm);
+}
+
+/*
+ * Fills the mix: 90 % idle frames, 8 % one sign event, 2 % bursts.
+ */
+static void buildMix() {
+    static const Event signs[] = {SlowDown, SpeedUp, TurnLeft, TurnRight, TakeLeft, TakeRight, PrepareCollision};
+    static const Event burst[] = {Collision, Measured, SpeedUp, TakeRight};
+    uint32_t seed = 12345;
+    for (uint32_t frame = 0; frame < FRAMES; frame++) {
+        seed = seed * 1103515245UL + 12345UL;
+        const uint32_t roll = (seed >> 16) % 100;
+        uint8_t n = 0;
+        if (roll >= 98) {
+            for (; n < MAX_FIRES; n++) {
+                mix[frame][n] = burst[n];
+            }
+        } else if (roll >= 90) {
+            mix[frame][n++] = signs[(seed >> 8) % 7];
+        }
+        mix[frame][n] = NUMBER_OF_EVENTS;
+        mixEvents += n;
+    }
+}
+
+template<typename Fire, typename Dispatch>
+static double timeMix(Fire fire, Dispatch dispatch) {
+    double best = 1e30;
+    for (int run = 0; run < RUNS; run++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < FRAMES; frame++) {
+            for (const uint8_t *event = mix[frame]; *event != NUMBER_OF_EVENTS; event++) {
+                fire(Event(*event));
+            }
+            dispatch();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = ns < best ? ns : best;
+    }
+    return best;
+}
+
+/*
+ * Times one frame's dispatch with nothing pending, the common case: the
+ * scan still walks every event, the current manager checks a mask or a
+ * list head.
+ */
+template<typename Drain>
+static double timeIdle(Drain drain) {
+    double best = 1e30;
+    for (int run = 0; run < RUNS; run++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 10000; i++) {
+            drain();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = ns < best ? ns : best;
+    }
+    return best / 10000.0;
+}
+
+/*
+ * Times firing and dispatching `depth` events at once, per event. Pops
+ * are constant time in every backend; the linked list's fire walks to
+ * its priority slot, so its cost grows with the depth.
+ */
+template<typename Fill, typename Drain>
+static double timeDepth(uint8_t depth, Fill fill, Drain drain) {
+    double best = 1e30;
+    for (int run = 0; run < RUNS; run++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 1000; i++) {
+            for (uint8_t e = 0; e < depth; e++) {
+                fill(Event(e));
+            }
+            drain();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = ns < best ? ns : best;
+    }
+    return best / (1000.0 * depth);
+}
+
+int main() {
+    buildMix();
+
+    ScanEventManager scan;
+    scanManager = &scan;
+    EventManager current;
+    manager = &current;
+    for (uint8_t e = 0; e < NUMBER_OF_EVENTS; e++) {
+        scan.setupListener(Event(e), count);
+        current.setupListener(Event(e), count, e == Collision || e == Measured ? Urgent : Normal);
+    }
+    scan.setupListener(SlowDown, scanSlowDown);
+    current.setupListener(SlowDown, slowDown);
+
+    const double scanNs = timeMix([&](Event e) { scan.fireEvent(e); }, [&]() { while (scan.next()); });
+    const double currentNs = timeMix([&](Event e) { current.fireEvent(e); },
+                                     [&]() { current.dispatch(EVENT_DISPATCH_BUDGET); });
+
+    const char *name = BENCH_LINKED_LIST ? "linked list" : "rings";
+    printf("%lu frames, %lu fired events (+ chained Reached5cm)\n",
+           static_cast<unsigned long>(FRAMES), static_cast<unsigned long>(mixEvents));
+    printf("backend      ns/frame\n");
+    printf("scan         %8.1f\n", scanNs / FRAMES);
+    printf("%-12s %8.1f  (%.2fx the scan)\n", name, currentNs / FRAMES, currentNs / scanNs);
+
+    printf("\nns/dispatch with nothing pending:\n");
+    printf("scan         %8.1f\n", timeIdle([&]() { while (scan.next()); }));
+    printf("%-12s %8.1f\n", name, timeIdle([&]() { current.dispatch(EVENT_DISPATCH_BUDGET); }));
+
+    printf("\nns/event with every event pending:\n");
+    printf("depth      scan  %s\n", name);
+    const uint8_t depths[] = {1, 3, NUMBER_OF_EVENTS / 2, NUMBER_OF_EVENTS};
+    for (uint8_t depth : depths) {
+        const double s = timeDepth(depth, [&](Event e) { scan.fireEvent(e); }, [&]() { while (scan.next()); });
+        const double c = timeDepth(depth, [&](Event e) { current.fireEvent(e); },
+                                   [&]() { current.dispatch(NUMBER_OF_EVENTS); });
+        printf("%5u  %8.1f  %8.1f\n", depth, s, c);
+    }
+    return handled == 0;
+}
@@ -0,0 +1,11 @@
+#!/bin/sh
+# Builds and runs research/event_benchmark.cpp for both EventManager backends.
+# Run from the repository root; needs a host g++.
+set -e
+out=${TMPDIR:-/tmp}
+for backend in 0 1; do
+    g++ -std=gnu++11 -O2 -Itest/support -Isrc -Ilib/Pololu3piPlus32U4/src \
+        -DBENCH_LINKED_LIST=$backend research/event_benchmark.cpp -o "$out/event_benchmark_$backend"
+    "$out/event_benchmark_$backend"
+    echo
+done
@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+"""
+File: lqr_design.py
+
+Description:
+Offline design of the speed-scheduled LQR line controller (src/LineController.cpp).
+Plain Python 3, no dependencies.
+
+Model (straight line, small angles), one frame T per controller step:
+    e'   = -v psi - L w        lateral offset of the sensor bar (mm)
+    psi' = w                   heading relative to the line (rad)
+    w'   = (c - w) / tau       yaw rate (rad/s) lagging the commanded rate c
+where the inner wheel-speed loop is the first-order lag tau, and c is the
+speed difference command of PathFollowing::follow() (left minus right wheel,
+one wheel slowed from maxSpeed) divided by the wheel track. The command
+computed from frame k's sensor reading takes effect one frame later, so the
+design state is [e, psi, w, c_prev].
+
+The gains are converted to the quantities follow() measures:
+    e     line position - 2000 (sensor units, 1000 per sensor spacing)
+    de    change of e per nominal frame
+    w     measured left - right wheel velocity (mm/s)
+    prev  previous speed difference command (speed units)
+and printed as the PROGMEM table rows, output * 256 per unit.
+
+    python3 research/lqr_design.py          prints the table
+    python3 research/lqr_design.py --sim    also compares against the PD law
+
+Author: agent
+Version: 2026-10-18
+"""
+
+import math
+import sys
+
+# Robot and loop parameters (see RATS.h).
+FRAME = 0.010                 # MILLISECONDS_PER_FRAME (s)
+TRACK = 96.0                  # WHEEL_DISTANCE (mm)
+SPEED_UNIT = 7.5              # SPEED_UNIT_MM_PER_S_X2 / 2 (mm/s per speed unit)
+SENSOR_SPACING = 8.0          # Line sensor pitch (mm)            TODO: Measure and adjust
+SENSOR_AHEAD = 35.0           # Sensor bar ahead of the axle (mm) TODO: Measure and adjust
+TAU = 0.025                   # Wheel-speed loop time constant (s) TODO: Measure and adjust
+MIN_DESIGN_SPEED = 150.0      # Lowest speed designed for (mm/s)
+
+# Table layout (GAIN_SCHEDULE_SHIFT, GAIN_SCHEDULE_POINTS).
+TABLE_STEP = 256
+TABLE_POINTS = 9
+
+# LQR weights: inverse squares of acceptable excursions.
+E_MAX = 4.0                   # mm
+PSI_MAX = 0.15                # rad
+W_MAX = 6.0                   # rad/s
+C_MAX = 6.0                   # rad/s of commanded yaw rate
+
+
+def matmul(a, b):
+    return [[sum(a[i][k] * b[k][j] for k in range(len(b))) for j in range(len(b[0]))] for i in range(len(a))]
+
+
+def transpose(a):
+    return [list(row) for row in zip(*a)]
+
+
+def add(a, b, scale=1.0):
+    return [[a[i][j] + scale * b[i][j] for j in range(len(a[0]))] for i in range(len(a))]
+
+
+def identity(n):
+    return [[1.0 if i == j else 0.0 for j in range(n)] for i in range(n)]
+
+
+def expm(m, terms=30):
+    result = identity(len(m))
+    term = identity(len(m))
+    for k in range(1, terms):
+        term = [[x / k for x in row] for row in matmul(term, m)]
+        result = add(result, term)
+    return result
+
+
+def discretize(v):
+    """Zero-order-hold model over one frame, augmented with the one-frame command delay."""
+    a = [[0.0, -v, -SENSOR_AHEAD], [0.0, 0.0, 1.0], [0.0, 0.0, -1.0 / TAU]]
+    b = [[0.0], [0.0], [1.0 / TAU]]
+    m = [[a[i][j] * FRAME for j in range(3)] + [b[i][0] * FRAME] for i in range(3)] + [[0.0] * 4]
+    phi = expm(m)
+    ad = [row[:3] for row in phi[:3]]
+    bd = [[row[3]] for row in phi[:3]]
+    # z = [e, psi, w, c_prev]: the plant is driven by last frame's command.
+    az = [ad[i] + [bd[i][0]] for i in range(3)] + [[0.0, 0.0, 0.0, 0.0]]
+    bz = [[0.0], [0.0], [0.0], [1.0]]
+    return az, bz
+
+
+def lqr(a, b, q, r, iterations=5000):
+    """Discrete LQR by iterating the Riccati equation (single input)."""
+    p = [row[:] for row in q]
+    k = None
+    for _ in range(iterations):
+        bt_p = matmul(transpose(b), p)
+        s = r + matmul(bt_p, b)[0][0]
+        k = [[x / s for x in matmul(bt_p, a)[0]]]
+        closed = add(a, matmul(b, k), -1.0)
+        p_next = add(q, matmul(matmul(transpose(a), p), closed))
+        if max(abs(p_next[i][j] - p[i][j]) for i in range(4) for j in range(4)) < 1e-12:
+            p = p_next
+            break
+        p = p_next
+    return k[0]
+
+
+def design(v):
+    """Gains on the measured quantities, output (speed units) * 256 per unit."""
+    v_design = max(v, MIN_DESIGN_SPEED)
+    a, b = discretize(v_design)
+    q = [[1.0 / E_MAX ** 2, 0, 0, 0], [0, 1.0 / PSI_MAX ** 2, 0, 0], [0, 0, 1.0 / W_MAX ** 2, 0], [0, 0, 0, 0]]
+    k_e, k_psi, k_w, k_c = lqr(a, b, q, 1.0 / C_MAX ** 2)
+
+    # c = -(k_e e + k_psi psi + k_w w + k_c c_prev), with psi = -(de/dt + L w) / v.
+    mm_per_unit = SENSOR_SPACING / 1000.0
+    rad_per_speed_unit = SPEED_UNIT / TRACK
+    g_e = -k_e * mm_per_unit
+    g_de = k_psi / v_design * mm_per_unit / FRAME
+    g_w = -(k_w - k_psi * SENSOR_AHEAD / v_design) / TRACK
+    g_prev = -k_c * rad_per_speed_unit
+    return [round(g * 256 / rad_per_speed_unit) for g in (g_e, g_de, g_w, g_prev)]
+
+
+def table():
+    return [design(i * TABLE_STEP) for i in range(TABLE_POINTS)]
+
+
+# --- Simulation -----------------------------------------------------------------------------
+
+def pd_gains(v):
+    """PID constants scheduled as in GainSchedule.cpp."""
+    scale = 1.0 if v <= 375 else math.sqrt(375.0 / v)
+    return 64 * scale, 256 * scale
+
+
+def simulate(controller, v_max, offset=8.0, duration=1.5):
+    """Step response to a lateral offset (mm) on a straight line, at maxSpeed v_max (mm/s)."""
+    dt = 0.0005
+    y, psi, v_left, v_right = offset, 0.0, v_max, v_max
+    target_left, target_right = v_max, v_max
+    pending = None
+    last_position = None
+    derivative = 0.0
+    last_diff = 0.0
+    max_speed = v_max / SPEED_UNIT
+    trace = []
+    t = 0.0
+    next_frame = 0.0
+    while t < duration:
+        if t >= next_frame - 1e-9:
+            next_frame += FRAME
+            e = y - SENSOR_AHEAD * math.sin(psi)
+            position = max(0, min(4000, round(2000 + e * 1000 / SENSOR_SPACING)))
+            error = position - 2000
+            change = 0 if last_position is None else position - last_position
+            last_position = position
+            w_measured = v_left - v_right  # mm/s
+            speed = (v_left + v_right) / 2
+            if controller == "pd":
+                kp, kd = pd_gains(speed)
+                derivative = (derivative * 312 + change * 16 * 625) / (312 + 625)
+                diff = kp * error / 256 + derivative * kd / 4096
+            else:
+                gains = lookup(speed)
+                diff = (gains[0] * error + gains[1] * change + gains[2] * w_measured + gains[3] * last_diff) / 256
+            diff = max(-max_speed, min(max_speed, diff))
+            last_diff = diff
+            left = max(0, min(max_speed, max_speed + diff))
+            right = max(0, min(max_speed, max_speed - diff))
+            # SpeedControl picks the targets up on its next 5 ms tick.
+            pending = (t + 0.005, left * SPEED_UNIT, right * SPEED_UNIT)
+        if pending and t >= pending[0]:
+            target_left, target_right = pending[1], pending[2]
+            pending = None
+        v_left += (target_left - v_left) * dt / TAU
+        v_right += (target_right - v_right) * dt / TAU
+        w = (v_left - v_right) / TRACK
+        v = (v_left + v_right) / 2
+        psi += w * dt
+        y += -v * math.sin(psi) * dt
+        trace.append((t, y - SENSOR_AHEAD * math.sin(psi)))
+        t += dt
+    return trace
+
+
+def lookup(speed):
+    rows = table_cache
+    speed = max(0.0, speed)
+    index = min(int(speed) // TABLE_STEP, TABLE_POINTS - 1)
+    if index == TABLE_POINTS - 1:
+        return rows[index]
+    fraction = (speed - index * TABLE_STEP) / TABLE_STEP
+    return [a + (b - a) * fraction for a, b in zip(rows[index], rows[index + 1])]
+
+
+def metrics(trace, offset):
+    """Overshoot (% of the step), 5 % settling time (s, None if it never settles) and the
+    peak offset over the last 0.5 s (mm)."""
+    overshoot = max(0.0, -min(e for _, e in trace)) / offset * 100
+    band = 0.05 * offset
+    settle = 0.0
+    for t, e in trace:
+        if abs(e) > band:
+            settle = t
+    end = trace[-1][0]
+    residual = max(abs(e) for t, e in trace if t > end - 0.5)
+    return overshoot, (None if residual > band else settle), residual
+
+
+table_cache = table()
+
+if __name__ == "__main__":
+    print("static const LineController::Gains gainTable[] PROGMEM = {")
+    for i, row in enumerate(table_cache):
+        print("        {%5d, %5d, %5d, %5d}, // %4d mm/s" % (row[0], row[1], row[2], row[3], i * TABLE_STEP))
+    print("};")
+
+    if "--sim" in sys.argv:
+        print()
+        print("8 mm step on a straight line, 3 s:")
+        print("               ----------- PD -----------   ----------- LQR ----------")
+        print("speed (mm/s)   overshoot  settle  residual   overshoot  settle  residual")
+        for speed in (375, 750, 1125, 1500, 1875):
+            row = []
+            for controller in ("pd", "lqr"):
+                overshoot, settle, residual = metrics(simulate(controller, speed, duration=3.0), 8.0)
+                row.append("%7.1f %%  %6s  %5.2f mm" % (overshoot, "never" if settle is None else "%d ms" % (settle * 1000), residual))
+            print("%5d       %s   %s" % (speed, row[0], row[1]))
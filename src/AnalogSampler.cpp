@@ -0,0 +1,124 @@
+/*
+ * File: AnalogSampler.cpp
+ *
+ * Description:
+ * This file implements the `AnalogSampler` namespace. The ADC runs in
+ * auto-trigger mode off the Timer0 overflow that millis() already uses;
+ * each completed conversion is folded into an exponential moving average
+ * for its channel and the multiplexer is switched to the next channel.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include "AnalogSampler.h"
+#include "Clock.h"
+#include "UserInterface.h"
+#include <util/atomic.h>
+
+// Filtered values are kept with this many fractional bits.
+#define SAMPLER_FRACTION_BITS 6
+
+// Each new sample moves the average by 1 / 2^SAMPLER_FILTER_SHIFT.
+#define SAMPLER_FILTER_SHIFT 3
+
+// Longest wait (µs) for the first pass over all channels, about 1 ms per channel.
+#define SAMPLER_PRIME_TIMEOUT 5000UL
+
+// Arduino pins of each channel, in the order of AnalogSampler::Channel.
+static const uint8_t channelPins[AnalogSampler::NUMBER_OF_CHANNELS] = {
+        A1,
+};
+
+// Filtered readings, Q(SAMPLER_FRACTION_BITS).
+static volatile uint16_t filtered[AnalogSampler::NUMBER_OF_CHANNELS];
+
+// Channel the conversion in progress belongs to.
+static volatile uint8_t current = 0;
+
+// Set once every channel has at least one reading.
+static volatile bool primed = false;
+
+/*
+ * Points the multiplexer at a channel, referenced to AVcc.
+ */
+static void selectChannel(uint8_t index) {
+    const uint8_t adcChannel = analogPinToChannel(channelPins[index] - A0);
+    ADMUX = (1 << REFS0) | (adcChannel & 0x07);
+    ADCSRB = (ADCSRB & ~(1 << MUX5)) | ((adcChannel & 0x08) ? (1 << MUX5) : 0);
+}
+
+/*
+ * Conversion complete: filter the result and advance to the next channel.
+ * The new multiplexer setting applies to the next triggered conversion.
+ */
+ISR(ADC_vect) {
+    const uint16_t sample = static_cast<uint16_t>(ADC) << SAMPLER_FRACTION_BITS;
+    const uint8_t index = current;
+
+    if (primed) {
+        const int32_t difference = static_cast<int32_t>(sample) - filtered[index];
+        filtered[index] += difference >> SAMPLER_FILTER_SHIFT;
+    } else {
+        filtered[index] = sample;
+    }
+
+    uint8_t next = index + 1;
+    if (next >= AnalogSampler::NUMBER_OF_CHANNELS) {
+        next = 0;
+        primed = true;
+    }
+    current = next;
+    selectChannel(next);
+}
+
+/*
+ * Configures the ADC for Timer0-overflow auto triggering with interrupts.
+ */
+void AnalogSampler::start() {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        current = 0;
+        primed = false;
+        selectChannel(0);
+
+        // ADTS = 0100: trigger on Timer0 overflow.
+        ADCSRB = (ADCSRB & (1 << MUX5)) | (1 << ADTS2);
+
+        // Enable, auto trigger, interrupt, clock/128 (125 kHz), clear ADIF.
+        ADCSRA = (1 << ADEN) | (1 << ADATE) | (1 << ADIE) | (1 << ADIF) |
+                 (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
+    }
+
+    // Wait for the first pass over all channels; a stuck ADC must not hang setup.
+    const microseconds started = Clock::now();
+    while (!primed) {
+        if (Clock::now() - started > SAMPLER_PRIME_TIMEOUT) {
+            UserInterface::throwError("ADC not sampling");
+            return;
+        }
+    }
+}
+
+/*
+ * Returns the filtered reading of a channel (0 - 1023).
+ */
+uint16_t AnalogSampler::read(Channel channel) {
+    uint16_t value;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        value = filtered[channel];
+    }
+    return (value + (1 << (SAMPLER_FRACTION_BITS - 1))) >> SAMPLER_FRACTION_BITS;
+}
+
+/*
+ * Returns the filtered battery voltage in millivolts.
+ * VBAT = 3 * raw * 5000 / 1024 = raw * 1875 / 128 (see readBatteryMillivolts()).
+ */
+uint16_t AnalogSampler::batteryMillivolts() {
+    uint16_t value;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        value = filtered[Battery];
+    }
+    const uint32_t scaled = static_cast<uint32_t>(value) * 1875;
+    return (scaled + (64UL << SAMPLER_FRACTION_BITS)) >> (7 + SAMPLER_FRACTION_BITS);
+}
@@ -0,0 +1,49 @@
+/*
+ * File: AnalogSampler.h
+ *
+ * Description:
+ * This header file declares the `AnalogSampler` namespace, a free-running,
+ * interrupt-driven ADC sampler. Conversions are auto-triggered by the
+ * Timer0 overflow (about 1 kHz), the ADC interrupt low-pass filters each
+ * configured channel and moves on to the next one, so reading a value
+ * never blocks. This replaces the blocking readBatteryMillivolts() for
+ * use inside the game loop.
+ *
+ * While the sampler runs, analogRead() must not be used.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+
+namespace AnalogSampler {
+
+    /*
+     * Enumerates the sampled channels. To sample another analog pin,
+     * add it here and to the pin table in AnalogSampler.cpp.
+     */
+    typedef enum ASC {
+        Battery,                 // Battery voltage divider on A1.
+        NUMBER_OF_CHANNELS       // The total number of channels (must remain last).
+    } Channel;
+
+    /*
+     * Configures the ADC and starts sampling in the background.
+     * Blocks only until every channel holds a first reading, and reports
+     * an error if that takes longer than a few milliseconds.
+     */
+    void start();
+
+    /*
+     * Returns the filtered reading of a channel (0 - 1023).
+     */
+    uint16_t read(Channel channel);
+
+    /*
+     * Returns the filtered battery voltage in millivolts, without blocking.
+     */
+    uint16_t batteryMillivolts();
+}
@@ -0,0 +1,32 @@
+/*
+ * File: Clock.h
+ *
+ * Description:
+ * This file defines the `Clock` namespace, the microsecond time base of the
+ * game loop. It reads the free-running Timer3 that the encoder library
+ * already runs at 2 MHz for edge timestamps, extended to 32 bits of
+ * microseconds by its overflow count. Unlike millis(), it has no 1.024 ms
+ * Timer0 steps, and unlike micros(), every module reads the same counter.
+ *
+ * Times wrap after 2^32 µs (about 71.6 minutes), so they must only be
+ * compared by subtraction.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+
+namespace Clock {
+
+    /**
+     * Returns the current time.
+     *
+     * @return The time since the encoders started (µs).
+     */
+    inline microseconds now() {
+        return Pololu3piPlus32U4::Encoders::getMicros();
+    }
+}
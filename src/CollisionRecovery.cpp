@@ -0,0 +1,162 @@
+/*
+ * File: CollisionRecovery.cpp
+ *
+ * Description:
+ * This file implements the `CollisionRecovery` namespace. Each call to
+ * step() checks the exit condition of the current phase and starts the
+ * next one; turns and pauses are PathFollowing motions, and the line is
+ * followed by the normal game loop in between.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include "CollisionRecovery.h"
+#include "IRSensor.h"
+#include "PathFollowing.h"
+#include "Clock.h"
+
+namespace CollisionRecovery {
+
+    Phase phase = Idle;
+
+    microseconds startTime = 0;      // Time of the collision.
+    microseconds phaseStart = 0;     // Time the current phase started.
+    int32_t searchStart = 0;         // Odometry distance when the search started (Q8 mm).
+    bool branchRight = false;        // True if the dots call for a right turn.
+
+    /*
+     * Ends the recovery and builds its report.
+     */
+    Report finish(Outcome outcome, const FixedOdometry &odometry) {
+        Report report;
+        report.outcome = outcome;
+        report.phase = phase;
+        report.duration = (Clock::now() - startTime) / 1000;
+        report.distance = phase >= FindingMarkers ? (odometry.getDistanceQ8() - searchStart) >> 8 : 0;
+
+        if (outcome != Recovered) {
+            PathFollowing::stop();
+        }
+        phase = Idle;
+        return report;
+    }
+
+    /*
+     * Moves to the next phase.
+     */
+    void enter(Phase next) {
+        phase = next;
+        phaseStart = Clock::now();
+    }
+}
+
+/*
+ * Starts a recovery. Stops path following and turns the robot around.
+ */
+void CollisionRecovery::begin() {
+    startTime = Clock::now();
+    PathFollowing::stop();
+    PathFollowing::turnAround();
+    enter(TurningAround);
+}
+
+/*
+ * Advances the recovery by one frame.
+ */
+Option<CollisionRecovery::Report> CollisionRecovery::step(const FixedOdometry &odometry) {
+    if (phase == Idle) {
+        return Option<Report>();
+    }
+
+    // Bound the search; the turns and the pause bound themselves.
+    if (phase >= FindingMarkers && phase <= ApproachingBranch) {
+        if (!PathFollowing::canFollowPath()) {
+            return Option<Report>(finish(LostLine, odometry));
+        }
+        if (Clock::now() - startTime > RECOVERY_TIMEOUT) {
+            return Option<Report>(finish(TimedOut, odometry));
+        }
+        if (odometry.getDistanceQ8() - searchStart > (static_cast<int32_t>(RECOVERY_MAX_DISTANCE) << 8)) {
+            return Option<Report>(finish(TooFar, odometry));
+        }
+    }
+
+    switch (phase) {
+        case TurningAround:
+            if (!PathFollowing::isBusy()) {
+                PathFollowing::start();
+                IRSensor::resetPathSignDetector();
+                PathFollowing::hold(RECOVERY_PAUSE);
+                enter(Pausing);
+            }
+            break;
+
+        case Pausing:
+            if (!PathFollowing::isBusy()) {
+                PathFollowing::speedUp();
+                searchStart = odometry.getDistanceQ8();
+                enter(FindingMarkers);
+            }
+            break;
+
+        case FindingMarkers:
+            if (IRSensor::getRemainingDots() >= 3) {
+                enter(CountingMarkers);
+            }
+            break;
+
+        case CountingMarkers:
+            if (IRSensor::getRemainingDots() >= 4 || Clock::now() - phaseStart >= RECOVERY_MARKER_WINDOW) {
+                branchRight = IRSensor::getRemainingDots() >= 4;
+                enter(ApproachingBranch);
+            }
+            break;
+
+        case ApproachingBranch:
+            if (branchRight ? IRSensor::seeingRight() : IRSensor::seeingLeft()) {
+                if (branchRight) {
+                    PathFollowing::turnRight();
+                } else {
+                    PathFollowing::turnLeft();
+                }
+                enter(TurningOntoPath);
+            }
+            break;
+
+        case TurningOntoPath:
+            if (!PathFollowing::isBusy()) {
+                return Option<Report>(finish(Recovered, odometry));
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return Option<Report>();
+}
+
+/*
+ * Checks if a recovery is in progress.
+ */
+bool CollisionRecovery::isActive() {
+    return phase != Idle;
+}
+
+/*
+ * Returns a short name for an outcome, for logging.
+ */
+const char *CollisionRecovery::describe(Outcome outcome) {
+    switch (outcome) {
+        case Recovered:
+            return "recovered";
+        case TimedOut:
+            return "timed out";
+        case TooFar:
+            return "too far";
+        case LostLine:
+            return "lost line";
+    }
+    return "?";
+}
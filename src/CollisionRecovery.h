@@ -0,0 +1,82 @@
+/*
+ * File: CollisionRecovery.h
+ *
+ * Description:
+ * This header file declares the `CollisionRecovery` namespace, the
+ * behaviour that takes the robot from a collision back onto the course:
+ * turn around, pause, follow the line back to the path sign, read its
+ * dots and turn onto the branch they indicate. It is a phase machine
+ * advanced once per frame, so the sensors, odometry and event processing
+ * keep running throughout. The marker search is bounded in time and
+ * distance; when the recovery ends, a report with its outcome, duration
+ * and distance is returned for logging.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+#include "FixedOdometry.h"
+
+namespace CollisionRecovery {
+
+    /*
+     * The phases of a recovery, in order.
+     */
+    typedef enum CRP {
+        Idle,                    // No recovery in progress.
+        TurningAround,           // Reversing direction after the collision.
+        Pausing,                 // Standing still before driving back.
+        FindingMarkers,          // Following the line back to the sign.
+        CountingMarkers,         // Waiting briefly for a fourth dot.
+        ApproachingBranch,       // Following until the branch is under the sensors.
+        TurningOntoPath,         // Turning onto the branch.
+        NUMBER_OF_PHASES         // The total number of phases (must remain last).
+    } Phase;
+
+    /*
+     * How a recovery ended.
+     */
+    typedef enum CRO {
+        Recovered,               // Back on the path, following.
+        TimedOut,                // The search took longer than RECOVERY_TIMEOUT.
+        TooFar,                  // The search drove further than RECOVERY_MAX_DISTANCE.
+        LostLine,                // The line was lost during the search.
+    } Outcome;
+
+    /*
+     * Summary of a finished recovery.
+     */
+    struct Report {
+        Outcome outcome;         // How the recovery ended.
+        Phase phase;             // The phase it ended in.
+        milliseconds duration;   // Time from the collision to the end (ms).
+        int16_t distance;        // Distance driven while searching (mm).
+    };
+
+    /*
+     * Starts a recovery. Stops path following and turns the robot around.
+     */
+    void begin();
+
+    /*
+     * Advances the recovery by one frame. Call once per frame after
+     * PathFollowing::step().
+     *
+     * odometry: The odometry, used to bound the search distance.
+     * returns: The report on the frame the recovery ends.
+     */
+    Option<Report> step(const FixedOdometry &odometry);
+
+    /*
+     * Checks if a recovery is in progress.
+     */
+    bool isActive();
+
+    /*
+     * Returns a short name for an outcome, for logging.
+     */
+    const char *describe(Outcome outcome);
+}
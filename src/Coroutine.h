@@ -0,0 +1,199 @@
+/*
+ * File: Coroutine.h
+ *
+ * Description:
+ * This file defines a small stackless coroutine runtime in the style of
+ * protothreads. A coroutine is a plain function whose body is wrapped in
+ * CO_BEGIN/CO_END; the await macros save the current line and return, and
+ * the next resume jumps straight back to it. Nothing is kept on the stack
+ * between resumes, so a coroutine costs only its `Coroutine` record plus
+ * whatever locals it explicitly stores (see CO_LOCALS).
+ *
+ * Coroutines are resumed once per frame by `CoroutineRuntime::resume()`,
+ * which also publishes the frame time (on the µs Clock) and odometry
+ * distance the await macros compare against.
+ *
+ * Rules for coroutine bodies: locals do not survive an await (keep them in
+ * the locals block or make them static), and an await must not appear
+ * inside a switch statement of the body.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+
+/**
+ * Time and distance of the current frame, shared by all coroutines.
+ */
+struct CoroutineClock {
+    microseconds now;                    // Frame time (µs).
+    int32_t distance;                    // Odometry distance (Q8 mm).
+};
+
+/**
+ * State of one coroutine.
+ */
+struct Coroutine {
+    typedef bool (*Body)(Coroutine &co); // Returns true while the coroutine is running.
+
+    Body body = nullptr;                 // The coroutine function.
+    void *locals = nullptr;              // State kept across awaits, if any.
+    uint8_t localsSize = 0;              // Size of the locals block (bytes).
+    bool running = false;                // False once the body has finished or was stopped.
+    uint16_t line = 0;                   // Resume point (source line), 0 to start over.
+    uint32_t mark = 0;                   // Start time or distance of the current wait.
+    const CoroutineClock *clock = nullptr; // Clock of the owning runtime.
+};
+
+// Starts a coroutine body.
+#define CO_BEGIN(co) switch ((co).line) { case 0:
+
+// Ends a coroutine body; the coroutine stops running.
+#define CO_END(co) } (co).line = 0; return false;
+
+// Yields until `condition` is true, re-checking it on every resume.
+#define CO_AWAIT(co, condition) \
+    do { (co).line = __LINE__; case __LINE__: if (!(condition)) return true; } while (0)
+
+// Yields for at least `ms` milliseconds.
+#define CO_AWAIT_TIME(co, ms) \
+    do { (co).mark = (co).clock->now; CO_AWAIT(co, (co).clock->now - (co).mark >= (ms) * 1000UL); } while (0)
+
+// Yields until the robot has driven at least `mm` millimetres.
+#define CO_AWAIT_DISTANCE(co, mm) \
+    do { \
+        (co).mark = (co).clock->distance; \
+        CO_AWAIT(co, static_cast<int32_t>((co).clock->distance - (co).mark) >= (static_cast<int32_t>(mm) << 8)); \
+    } while (0)
+
+// Yields once, resuming on the next frame.
+#define CO_YIELD(co) \
+    do { (co).line = __LINE__; return true; case __LINE__:; } while (0)
+
+// Accesses the coroutine's locals block as a `Type`.
+#define CO_LOCALS(co, Type) (*static_cast<Type *>((co).locals))
+
+/**
+ * A fixed set of coroutines resumed together by the game loop.
+ *
+ * @tparam Capacity Maximum number of coroutines.
+ */
+template<uint8_t Capacity>
+class CoroutineRuntime {
+private:
+    Coroutine coroutines[Capacity];      // Coroutine records.
+    uint8_t count = 0;                   // Number of spawned coroutines.
+    CoroutineClock clock = {0, 0};       // Clock of the current frame.
+
+public:
+    typedef uint8_t Id;                  // Index of a spawned coroutine.
+
+    /**
+     * Registers a coroutine. It does not run until started. Once
+     * Capacity coroutines are registered, further ones are ignored.
+     *
+     * @param body The coroutine function.
+     * @param locals State kept across awaits (optional).
+     * @param localsSize Size of the locals block in bytes.
+     * @return The coroutine's id, Capacity if the runtime is full.
+     */
+    Id spawn(Coroutine::Body body, void *locals = nullptr, uint8_t localsSize = 0) {
+        if (count == Capacity) {
+            return Capacity;
+        }
+        Coroutine &co = coroutines[count];
+        co.body = body;
+        co.locals = locals;
+        co.localsSize = localsSize;
+        co.clock = &clock;
+        return count++;
+    }
+
+    /**
+     * Starts (or restarts) a coroutine from the top of its body.
+     */
+    void start(Id id) {
+        if (id >= count) {
+            return;
+        }
+        coroutines[id].line = 0;
+        coroutines[id].running = true;
+    }
+
+    /**
+     * Stops a coroutine wherever it is waiting.
+     */
+    void stop(Id id) {
+        if (id >= count) {
+            return;
+        }
+        coroutines[id].running = false;
+    }
+
+    /**
+     * Starts every coroutine from the top.
+     */
+    void startAll() {
+        for (Id i = 0; i < count; i++) {
+            start(i);
+        }
+    }
+
+    /**
+     * Stops every coroutine.
+     */
+    void stopAll() {
+        for (Id i = 0; i < count; i++) {
+            stop(i);
+        }
+    }
+
+    /**
+     * Checks if a coroutine is still running.
+     */
+    bool isRunning(Id id) const {
+        return id < count && coroutines[id].running;
+    }
+
+    /**
+     * Resumes every running coroutine once.
+     *
+     * @param now Current time (µs).
+     * @param distance Current odometry distance (Q8 mm).
+     */
+    void resume(microseconds now, int32_t distance) {
+        clock.now = now;
+        clock.distance = distance;
+        for (Id i = 0; i < count; i++) {
+            Coroutine &co = coroutines[i];
+            if (co.running) {
+                co.running = co.body(co);
+            }
+        }
+    }
+
+    /**
+     * Gets the RAM used by one coroutine: its record plus its locals.
+     *
+     * @return The size in bytes.
+     */
+    size_t ramUsage(Id id) const {
+        return id < count ? sizeof(Coroutine) + coroutines[id].localsSize : 0;
+    }
+
+    /**
+     * Gets the RAM used by the runtime and all its coroutines' locals.
+     *
+     * @return The size in bytes.
+     */
+    size_t ramUsage() const {
+        size_t total = sizeof(*this);
+        for (Id i = 0; i < count; i++) {
+            total += coroutines[i].localsSize;
+        }
+        return total;
+    }
+};
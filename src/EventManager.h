@@ -13,38 +13,185 @@
 
 #pragma once
 
+#include "RATS.h"
+#include "Clock.h"
+#if EVENT_LINKED_LIST
+#include "TaskPriorityLinkedList.h"
+#endif
+
 // Enumerates all possible events.
 typedef enum Event {
-    CheckFirst2Dots,         // Check the first two dots.
-    SlowDown,                // Event indicating to slow down.
+    SlowDown,                // Event indicating to slow down (two dots on the left).
     SpeedUp,                 // Event indicating to speed up.
-    Reached5cm,              // Triggered when 5 cm distance is reached.
-    Check5cm,                // Check the 5 cm distance.
+    Reached5cm,              // Triggered MEASUREMENT_DISTANCE past the elevation dots.
     Collision,               // Event triggered during a collision.
     TurnLeft,                // Triggered to perform a left turn.
     TurnRight,               // Triggered to perform a right turn.
     TakeLeft,                // Take a left action.
     TakeRight,               // Take a right action.
-    CheckFirst3DotsRight,    // Check the first three dots on the right.
-    PrepareCollision,        // Prepare for a collision scenario.
+    PrepareCollision,        // Prepare for a collision scenario (three dots on the right).
+    Measured,                // The stop to take a measurement is over.
     NUMBER_OF_EVENTS         // The total number of events (must remain last).
 } Event;
 
+// Priority classes; pending events of a lower class are dispatched first.
+typedef enum EventPriority {
+    Urgent,                  // Dispatched before any normal event.
+    Normal,                  // Default class.
+    NUMBER_OF_PRIORITIES     // The total number of classes (must remain last).
+} EventPriority;
+
 typedef void (*Callback)(Event event); // Function pointer for event callbacks.
 
 /*
  * Manages events and their associated callbacks.
  * Provides functionality for firing events, setting up listeners,
  * and processing events in order.
+ *
+ * Fired events wait in one FIFO ring per priority class; a bitmask of
+ * queued events makes firing an already pending event a no-op, so each
+ * ring holds at most NUMBER_OF_EVENTS entries and never overflows. Firing
+ * and dispatching are constant time, and dispatch order is the firing
+ * order within a class. Cancelled events stay in their ring, marked, and
+ * are dropped when they reach the head. With EVENT_LINKED_LIST set, a
+ * `TaskPriorityLinkedList` holds the pending events instead.
+ *
+ * Delayed events sit in a timer wheel of EVENT_TIMER_SLOTS slots, one per
+ * 2^EVENT_TIMER_SHIFT µs of the frame clock, as a linked list per slot. A
+ * waiting event costs nothing until advance() reaches its slot; delays
+ * longer than one wheel revolution simply stay in their slot for more
+ * rounds.
+ *
+ * Distance-triggered events are kept in a list sorted by target odometry
+ * distance, so each frame only compares the distance against its head.
+ *
+ * With EVENT_TRACE set, the last EVENT_TRACE_SIZE dispatches are kept in
+ * a ring with their fire time, dispatch time and callback duration.
+ * Without it, none of the trace code or storage is compiled.
  */
 class EventManager {
-    struct Promise {
-        bool fired = false;              // Indicates if the event has been triggered.
-        Callback callback = nullptr;     // Callback function for the event.
+    static const uint8_t NO_EVENT = 0xFF; // End of a timer slot list.
+    static_assert(NUMBER_OF_EVENTS <= 32, "EventManager event masks too small");
+    static_assert((EVENT_TIMER_SLOTS & (EVENT_TIMER_SLOTS - 1)) == 0, "EVENT_TIMER_SLOTS must be a power of two");
+
+#if EVENT_LINKED_LIST
+    TaskPriorityLinkedList<Event, Callback, NUMBER_OF_EVENTS> ready; // Pending events in priority order.
+#else
+    static const uint8_t QUEUE_SIZE = 16; // Ring capacity, a power of two >= NUMBER_OF_EVENTS.
+    static_assert(NUMBER_OF_EVENTS <= QUEUE_SIZE, "EventManager ring too small");
+
+    struct Queue {
+        uint8_t events[QUEUE_SIZE];      // Queued events, oldest at head.
+        uint8_t head = 0;                // Index of the oldest event.
+        uint8_t count = 0;               // Number of queued events.
     };
 
-    struct Promise callbackList[NUMBER_OF_EVENTS]; // Array of promises for events.
-    int last = 0;                                   // Index of the last processed event.
+    Callback callbacks[NUMBER_OF_EVENTS] = {};   // Callback for each event.
+    uint8_t priorities[NUMBER_OF_EVENTS] = {};   // Priority class of each event.
+    struct Queue queues[NUMBER_OF_PRIORITIES];   // One FIFO per priority class.
+    uint32_t queued = 0;                         // Bit n is set while event n is in a ring.
+    uint32_t cancelled = 0;                      // Bit n is set if queued event n was cancelled.
+#endif
+
+    uint32_t deadlines[NUMBER_OF_EVENTS] = {};   // Due time of each armed timer (µs).
+    uint8_t nextTimer[NUMBER_OF_EVENTS] = {};    // Next event in the same wheel slot.
+    uint8_t wheel[EVENT_TIMER_SLOTS];            // First event in each wheel slot.
+    uint32_t armed = 0;                          // Bit n is set while event n has a timer.
+    uint32_t clock = 0;                          // Frame time of the last advance() (µs).
+    uint32_t wheelTick = 0;                      // Last wheel tick processed.
+
+    int32_t targets[NUMBER_OF_EVENTS] = {};      // Target distance of each distance trigger (Q8 mm).
+    uint8_t nextTarget[NUMBER_OF_EVENTS] = {};   // Next event in the distance list.
+    uint8_t targetHead = NO_EVENT;               // Distance trigger with the nearest target.
+    uint32_t waiting = 0;                        // Bit n is set while event n has a distance trigger.
+    int32_t distance = 0;                        // Odometry distance at the last advance() (Q8 mm).
+
+#if EVENT_TRACE
+public:
+    /*
+     * One dispatched event in the trace.
+     */
+    struct TraceRecord {
+        uint8_t event;                           // The event.
+        uint32_t fired;                          // When it was fired (µs).
+        uint32_t started;                        // When its callback started (µs).
+        uint16_t duration;                       // How long its callback ran (µs).
+    };
+
+private:
+    uint32_t firedAt[NUMBER_OF_EVENTS] = {};     // Fire time of each queued event (µs).
+    TraceRecord trace[EVENT_TRACE_SIZE];         // The last EVENT_TRACE_SIZE dispatches.
+    uint8_t traceStart = 0;                      // Index of the oldest record.
+    uint8_t traceCount = 0;                      // Number of records.
+#endif
+
+#if !EVENT_LINKED_LIST
+    /*
+     * Removes and returns the oldest live event of the highest non-empty
+     * class, or NUMBER_OF_EVENTS if only cancelled events were left.
+     */
+    Event pop() {
+        for (uint8_t i = 0; i < NUMBER_OF_PRIORITIES; i++) {
+            Queue &queue = queues[i];
+            while (queue.count != 0) {
+                const Event event = Event(queue.events[queue.head]);
+                queue.head = (queue.head + 1) & (QUEUE_SIZE - 1);
+                queue.count -= 1;
+
+                const uint32_t bit = 1UL << event;
+                queued &= ~bit;
+                if (cancelled & bit) {
+                    cancelled &= ~bit;
+                    continue;
+                }
+                return event;
+            }
+        }
+        return NUMBER_OF_EVENTS;
+    }
+#endif
+
+    /*
+     * Returns the wheel slot for a due time: the first tick at or after it,
+     * so every timer in a slot is due once advance() reaches that tick.
+     */
+    static uint8_t slotOf(uint32_t time) {
+        return ((time + (1UL << EVENT_TIMER_SHIFT) - 1) >> EVENT_TIMER_SHIFT) & (EVENT_TIMER_SLOTS - 1);
+    }
+
+    /*
+     * Unlinks an event from its timer slot, if it is armed.
+     */
+    void disarm(Event event) {
+        const uint32_t bit = 1UL << event;
+        if (!(armed & bit)) {
+            return;
+        }
+        armed &= ~bit;
+
+        uint8_t *link = &wheel[slotOf(deadlines[event])];
+        while (*link != event) {
+            link = &nextTimer[*link];
+        }
+        *link = nextTimer[event];
+    }
+
+    /*
+     * Unlinks an event from the distance list, if it is waiting.
+     */
+    void unwait(Event event) {
+        const uint32_t bit = 1UL << event;
+        if (!(waiting & bit)) {
+            return;
+        }
+        waiting &= ~bit;
+
+        uint8_t *link = &targetHead;
+        while (*link != event) {
+            link = &nextTarget[*link];
+        }
+        *link = nextTarget[event];
+    }
 
 public:
     /*
@@ -52,16 +199,160 @@ public:
      * Initializes an empty manager.
      */
     EventManager() {
-        // Default initialization.
+#if !EVENT_LINKED_LIST
+        for (int i = 0; i < NUMBER_OF_EVENTS; i++) {
+            priorities[i] = Normal;
+        }
+#endif
+        for (int i = 0; i < EVENT_TIMER_SLOTS; i++) {
+            wheel[i] = NO_EVENT;
+        }
     }
 
     /*
-     * Fires an event, marking it as triggered.
+     * Fires an event, queueing it behind the pending events of its class.
+     * Firing an event that is already pending has no effect.
      *
      * event: The event to fire.
      */
     void fireEvent(Event event) {
-        callbackList[event].fired = true;
+#if EVENT_LINKED_LIST
+        if (ready.isQueued(event)) {
+            return;
+        }
+        ready.fire(event);
+#else
+        const uint32_t bit = 1UL << event;
+        if (queued & bit) {
+            cancelled &= ~bit;
+            return;
+        }
+        queued |= bit;
+        Queue &queue = queues[priorities[event]];
+        queue.events[(queue.head + queue.count) & (QUEUE_SIZE - 1)] = event;
+        queue.count += 1;
+#endif
+#if EVENT_TRACE
+        firedAt[event] = Clock::now();
+#endif
+    }
+
+    /*
+     * Fires an event once the frame clock reaches a given time.
+     * Replaces any timer the event already has.
+     *
+     * event: The event to fire.
+     * time: Frame clock time to fire at (µs); a past time fires on the next advance().
+     */
+    void fireEventAt(Event event, uint32_t time) {
+        disarm(event);
+
+        // Never file into a slot that advance() has already passed.
+        const uint32_t earliest = (wheelTick << EVENT_TIMER_SHIFT) + 1;
+        if (static_cast<int32_t>(time - earliest) < 0) {
+            time = earliest;
+        }
+
+        deadlines[event] = time;
+        uint8_t &slot = wheel[slotOf(time)];
+        nextTimer[event] = slot;
+        slot = event;
+        armed |= 1UL << event;
+    }
+
+    /*
+     * Fires an event after a delay on the frame clock.
+     * Replaces any timer the event already has.
+     *
+     * event: The event to fire.
+     * delay: Delay from the last advance() (ms).
+     */
+    void fireEventAfter(Event event, uint32_t delay) {
+        fireEventAt(event, clock + delay * 1000UL);
+    }
+
+    /*
+     * Fires an event once the robot has driven a given distance further,
+     * measured by the odometry passed to advance(). Driving backward
+     * counts against it. Replaces any distance trigger the event has.
+     *
+     * event: The event to fire.
+     * mm: Distance from the last advance() (mm).
+     */
+    void fireAtDistance(Event event, int16_t mm) {
+        unwait(event);
+
+        const int32_t target = distance + (static_cast<int32_t>(mm) << 8);
+        targets[event] = target;
+
+        // Keep the list sorted; ties keep their firing order.
+        uint8_t *link = &targetHead;
+        while (*link != NO_EVENT && targets[*link] - target <= 0) {
+            link = &nextTarget[*link];
+        }
+        nextTarget[event] = *link;
+        *link = event;
+        waiting |= 1UL << event;
+    }
+
+    /*
+     * Cancels an event: its timer, if armed, its distance trigger, if
+     * waiting, and its dispatch, if pending.
+     *
+     * event: The event to cancel.
+     */
+    void cancel(Event event) {
+        disarm(event);
+        unwait(event);
+#if EVENT_LINKED_LIST
+        ready.remove(event);
+#else
+        if (queued & (1UL << event)) {
+            cancelled |= 1UL << event;
+        }
+#endif
+    }
+
+    /*
+     * Advances the timer wheel to the current frame time and the distance
+     * list to the current odometry distance, firing every trigger that
+     * has come due. Call once per frame, before dispatching.
+     *
+     * now: Current frame time (µs, see Clock).
+     * travelled: Current odometry distance (Q8 mm).
+     */
+    void advance(uint32_t now, int32_t travelled) {
+        distance = travelled;
+        while (targetHead != NO_EVENT && targets[targetHead] - travelled <= 0) {
+            const Event event = Event(targetHead);
+            targetHead = nextTarget[event];
+            waiting &= ~(1UL << event);
+            fireEvent(event);
+        }
+
+        // Ticks run modulo 2^(32 - EVENT_TIMER_SHIFT) with the clock; a
+        // wrap looks like a long gap and sweeps the whole wheel once.
+        const uint32_t nowTick = now >> EVENT_TIMER_SHIFT;
+        uint32_t ticks = nowTick - wheelTick;
+        if (ticks > EVENT_TIMER_SLOTS) {
+            ticks = EVENT_TIMER_SLOTS;
+        }
+        clock = now;
+
+        for (uint32_t tick = nowTick - ticks + 1; ticks > 0; tick++, ticks--) {
+            uint8_t *link = &wheel[tick & (EVENT_TIMER_SLOTS - 1)];
+            while (*link != NO_EVENT) {
+                const Event event = Event(*link);
+                if (static_cast<int32_t>(deadlines[event] - now) <= 0) {
+                    *link = nextTimer[event];
+                    armed &= ~(1UL << event);
+                    fireEvent(event);
+                } else {
+                    link = &nextTimer[event];
+                }
+            }
+        }
+        wheelTick = nowTick;
     }
 
     /*
@@ -69,37 +360,187 @@ public:
      *
      * event: The event to listen for.
      * callback: The function to be called when the event is triggered.
+     * priority: The event's priority class.
      */
-    void setupListener(Event event, Callback callback) {
-        callbackList[event].callback = callback;
+    void setupListener(Event event, Callback callback, EventPriority priority = Normal) {
+#if EVENT_LINKED_LIST
+        ready.setUpTask(event, callback, priority);
+#else
+        callbacks[event] = callback;
+        priorities[event] = priority;
+#endif
     }
 
     /*
-     * Cancels all active events by resetting their fired status.
+     * Cancels all pending events and timers.
      */
     void cancelAllEvents() {
-        for (int i = last; i < NUMBER_OF_EVENTS; i++) {
-            callbackList[i].fired = false;
+#if EVENT_LINKED_LIST
+        ready.reset();
+#else
+        for (int i = 0; i < NUMBER_OF_PRIORITIES; i++) {
+            queues[i].head = 0;
+            queues[i].count = 0;
+        }
+        queued = 0;
+        cancelled = 0;
+#endif
+        for (int i = 0; i < EVENT_TIMER_SLOTS; i++) {
+            wheel[i] = NO_EVENT;
         }
+        armed = 0;
+        targetHead = NO_EVENT;
+        waiting = 0;
+    }
+
+    /*
+     * Checks if an event is waiting to be dispatched.
+     *
+     * event: The event to check.
+     */
+    bool isPending(Event event) const {
+#if EVENT_LINKED_LIST
+        return ready.isQueued(event);
+#else
+        return (queued & ~cancelled) & (1UL << event);
+#endif
+    }
+
+    /*
+     * Checks if an event has a timer running.
+     *
+     * event: The event to check.
+     */
+    bool isArmed(Event event) const {
+        return armed & (1UL << event);
+    }
+
+    /*
+     * Checks if an event has a distance trigger waiting.
+     *
+     * event: The event to check.
+     */
+    bool isWaiting(Event event) const {
+        return waiting & (1UL << event);
     }
 
     /*
-     * Processes the next triggered event, calling its callback if available.
+     * Processes the next pending event, calling its callback if available.
      *
      * returns: True if an event was processed; false otherwise.
      */
     bool next() {
-        for (int i = last; i < NUMBER_OF_EVENTS; i++) {
-            if (callbackList[i].fired) {
-                callbackList[i].fired = false; // Reset the fired status.
-                if (callbackList[i].callback != nullptr) {
-                    callbackList[i].callback(Event(i)); // Call the event's callback.
-                }
-                last += 1; // Move to the next event.
-                return true;
-            }
+#if EVENT_LINKED_LIST
+        Option<Event> popped = ready.pop();
+        if (!popped.exists()) {
+            return false;
+        }
+        const Event event = popped.get();
+        const Callback callback = ready.getTask(event);
+#else
+        if ((queued & ~cancelled) == 0) {
+            return false;
+        }
+        const Event event = pop();
+        if (event == NUMBER_OF_EVENTS) {
+            return false;
+        }
+        const Callback callback = callbacks[event];
+#endif
+
+#if EVENT_TRACE
+        const microseconds started = Clock::now();
+#endif
+        if (callback != nullptr) {
+            callback(event);
+        }
+#if EVENT_TRACE
+        TraceRecord &record = trace[(traceStart + traceCount) % EVENT_TRACE_SIZE];
+        record.event = event;
+        record.fired = firedAt[event];
+        record.started = started;
+        const microseconds duration = Clock::now() - started;
+        record.duration = duration > 0xFFFF ? 0xFFFF : duration;
+        if (traceCount < EVENT_TRACE_SIZE) {
+            traceCount += 1;
+        } else {
+            traceStart = (traceStart + 1) % EVENT_TRACE_SIZE;
+        }
+#endif
+        return true;
+    }
+
+    /*
+     * Dispatches the events that are pending now, up to `budget` of them.
+     * Events fired by the callbacks wait for the next call, so an event
+     * that re-fires itself runs at most once per call.
+     *
+     * budget: Maximum number of events to dispatch.
+     * returns: The number of events dispatched.
+     */
+    uint8_t dispatch(uint8_t budget) {
+#if EVENT_LINKED_LIST
+        uint8_t round = ready.size();
+#else
+        uint8_t round = 0;
+        for (int i = 0; i < NUMBER_OF_PRIORITIES; i++) {
+            round += queues[i].count;
+        }
+#endif
+        if (round > budget) {
+            round = budget;
+        }
+        uint8_t dispatched = 0;
+        while (dispatched < round && next()) {
+            dispatched += 1;
+        }
+        return dispatched;
+    }
+
+#if EVENT_TRACE
+    /*
+     * Returns the number of records in the trace.
+     */
+    uint8_t traceSize() const {
+        return traceCount;
+    }
+
+    /*
+     * Returns a trace record, oldest first.
+     *
+     * index: 0 .. traceSize() - 1.
+     */
+    const TraceRecord &getTrace(uint8_t index) const {
+        return trace[(traceStart + index) % EVENT_TRACE_SIZE];
+    }
+
+    /*
+     * Clears the trace.
+     */
+    void clearTrace() {
+        traceStart = 0;
+        traceCount = 0;
+    }
+
+    /*
+     * Prints the trace as CSV (event, fired, started, duration in µs),
+     * oldest first, e.g. to Serial over USB.
+     *
+     * out: Anything with Arduino's print()/println().
+     */
+    template<typename Output>
+    void dumpTrace(Output &out) const {
+        out.println("event,fired_us,started_us,duration_us");
+        for (uint8_t i = 0; i < traceCount; i++) {
+            const TraceRecord &record = getTrace(i);
+            out.print(static_cast<long>(record.event));
+            out.print(",");
+            out.print(static_cast<long>(record.fired));
+            out.print(",");
+            out.print(static_cast<long>(record.started));
+            out.print(",");
+            out.println(static_cast<long>(record.duration));
         }
-        last = 0; // Reset index if no events remain.
-        return false;
     }
+#endif
 };
@@ -0,0 +1,296 @@
+/*
+ * File: FixedOdometry.h
+ *
+ * Description:
+ * This file defines the `FixedOdometry` class, an integer-only variant of
+ * `RobotOdometry`. It accumulates encoder ticks, keeps the heading as a
+ * wrapped binary angle (so no atan2 normalization is needed) and uses the
+ * FixedTrig tables for sin/cos. The pose is kept in Q8 fixed-point
+ * millimetres and converted to doubles only for display and logging.
+ *
+ * The encoder ISRs integrate the pose at tick granularity; update() only
+ * folds one atomic snapshot of that accumulator into the pose, so accuracy
+ * no longer depends on frame timing (including inside blocking turns).
+ * When a gyro rate is supplied, the heading comes from a `HeadingFilter`
+ * instead and the encoder displacement is rotated onto it, so wheel slip
+ * does not corrupt the pose.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+#include "Clock.h"
+#include "FixedTrig.h"
+#include "HeadingFilter.h"
+#include "Pololu3piPlus32U4Encoders.h"
+
+/**
+ * Class for calculating and managing robot odometry in fixed point.
+ * Follows the same conventions as `RobotOdometry`: x is forward from the
+ * starting pose, y is negated (left turns drive y negative) and theta is
+ * counter-clockwise positive.
+ */
+class FixedOdometry {
+private:
+    const uint32_t headingPerTick;       // Heading change per differential tick (2^32 per turn).
+    const int32_t mmPerHalfTickQ16;      // Half of the distance per tick, Q16 millimetres.
+
+    int32_t x;                           // Current x position of the robot (Q8 mm).
+    int32_t y;                           // Current y position of the robot (Q8 mm).
+    uint32_t heading;                    // Current orientation (2^32 per turn, wraps).
+    uint32_t encoderHeading;             // Orientation from the wheel difference alone (2^32 per turn).
+    int32_t distance;                    // Distance travelled along the path (Q8 mm, reversing subtracts).
+
+    int16_t prevLeft;                    // Previous left encoder reading.
+    int16_t prevRight;                   // Previous right encoder reading.
+
+    HeadingFilter headingFilter;         // Gyro + encoder heading fusion.
+    microseconds lastUpdate;             // Time of the previous fused update (µs).
+
+    /**
+     * Folds one ISR snapshot into the pose, rotating its displacement
+     * by `skew` (the fused heading minus the encoder heading).
+     */
+    void integrate(const Pololu3piPlus32U4::Encoders::PoseSnapshot &snapshot, FixedTrig::BinaryAngle skew) {
+        const int16_t deltaLeft = static_cast<uint16_t>(snapshot.countLeft) - static_cast<uint16_t>(prevLeft);
+        const int16_t deltaRight = static_cast<uint16_t>(snapshot.countRight) - static_cast<uint16_t>(prevRight);
+        distance += ((static_cast<int32_t>(deltaLeft) + deltaRight) * mmPerHalfTickQ16 + 128) >> 8;
+        prevLeft = snapshot.countLeft;
+        prevRight = snapshot.countRight;
+
+        int32_t dx = snapshot.displacementX;
+        int32_t dy = snapshot.displacementY;
+        if (skew != 0) {
+            const int16_t c = FixedTrig::cosQ15(skew);
+            const int16_t s = FixedTrig::sinQ15(skew);
+            const int32_t rx = FixedTrig::mulQ15(dx, c) - FixedTrig::mulQ15(dy, s);
+            dy = FixedTrig::mulQ15(dx, s) + FixedTrig::mulQ15(dy, c);
+            dx = rx;
+        }
+
+        // Displacement is in half ticks * 2^-15; scale to Q16 mm, then round to Q8.
+        const int16_t scale = mmPerHalfTickQ16;
+        x += (FixedTrig::mulQ15(dx, scale) + 128) >> 8;
+        y -= (FixedTrig::mulQ15(dy, scale) + 128) >> 8;
+    }
+
+public:
+    /**
+     * Constructor to initialize odometry parameters.
+     * Takes the same arguments as `RobotOdometry`; the floating point
+     * values are only used here to derive the integer scale factors.
+     *
+     * @param wheelDist Distance between the robot's wheels (default: 86.0 mm).
+     * @param ticksPerRev Encoder ticks per wheel revolution (default: 358.3).
+     * @param wheelDiam Diameter of the robot's wheels (default: 32.0 mm).
+     * @param mmPerTick Distance traveled per encoder tick (default: calculated based on wheel diameter and ticks).
+     */
+    FixedOdometry(double wheelDist = 86.0, double ticksPerRev = 358.3, double wheelDiam = 32.0,
+                  double mmPerTick = (M_PI * 32) / 358.3) :
+            headingPerTick(lround(mmPerTick / wheelDist / (2.0 * M_PI) * 4294967296.0)),
+            mmPerHalfTickQ16(lround(mmPerTick / 2.0 * 65536.0)),
+            x(0),
+            y(0),
+            heading(0),
+            encoderHeading(0),
+            distance(0),
+            prevLeft(0),
+            prevRight(0),
+            lastUpdate(0) {
+        (void) ticksPerRev;
+        (void) wheelDiam;
+    }
+
+    /**
+     * Resets the robot's odometry to the origin (x=0, y=0, theta=0)
+     * and restarts the per-tick accumulator in the encoder ISRs. The
+     * encoder counts are never cleared, so the distance starts from the
+     * counts as they are now.
+     */
+    void reset() {
+        x = 0;
+        y = 0;
+        heading = 0;
+        encoderHeading = 0;
+        distance = 0;
+        Pololu3piPlus32U4::Encoders::enablePoseTracking(headingPerTick);
+
+        Pololu3piPlus32U4::Encoders::PoseSnapshot snapshot;
+        Pololu3piPlus32U4::Encoders::getPoseSnapshot(snapshot);
+        prevLeft = snapshot.countLeft;
+        prevRight = snapshot.countRight;
+
+        headingFilter.reset(0);
+        lastUpdate = Clock::now();
+    }
+
+    /**
+     * Folds the displacement accumulated by the encoder ISRs since the
+     * last call into the pose. Reads a single atomic snapshot.
+     */
+    void update() {
+        Pololu3piPlus32U4::Encoders::PoseSnapshot snapshot;
+        Pololu3piPlus32U4::Encoders::getPoseSnapshot(snapshot);
+
+        heading = snapshot.heading;
+        encoderHeading = snapshot.heading;
+        integrate(snapshot, 0);
+    }
+
+    /**
+     * Like update(), but fuses the z-gyro into the heading first.
+     * Call this every frame; the gyro bias is learned while stopped.
+     *
+     * @param gyroRate Calibrated z-gyro reading (0.07 dps per digit).
+     */
+    void update(int16_t gyroRate) {
+        Pololu3piPlus32U4::Encoders::PoseSnapshot snapshot;
+        Pololu3piPlus32U4::Encoders::getPoseSnapshot(snapshot);
+
+        const microseconds now = Clock::now();
+        const bool wheelsStopped = snapshot.countLeft == prevLeft && snapshot.countRight == prevRight;
+        headingFilter.update(snapshot.heading, wheelsStopped, gyroRate, now - lastUpdate);
+        lastUpdate = now;
+
+        encoderHeading = snapshot.heading;
+        heading = headingFilter.getHeading();
+        integrate(snapshot, (heading - snapshot.heading) >> 16);
+    }
+
+    /**
+     * Moves the position toward a known reference, e.g. a landmark.
+     *
+     * @param referenceX Reference x position (Q8 mm).
+     * @param referenceY Reference y position (Q8 mm).
+     * @param blendShift Moves 1 / 2^blendShift of the way; 0 snaps.
+     */
+    void correct(int32_t referenceX, int32_t referenceY, uint8_t blendShift) {
+        x += (referenceX - x) >> blendShift;
+        y += (referenceY - y) >> blendShift;
+    }
+
+    /**
+     * Gets the heading filter, for its bias and slip statistics.
+     */
+    const HeadingFilter &getHeadingFilter() const {
+        return headingFilter;
+    }
+
+    /**
+     * Updates the robot's position and orientation from two encoder
+     * readings, integrating once per call. This is the frame-level
+     * alternative to update() for when ISR tracking is not available.
+     * The raw 16-bit encoder counts may wrap around freely between calls.
+     *
+     * @param leftTicks Current left encoder tick count.
+     * @param rightTicks Current right encoder tick count.
+     */
+    void update(int16_t leftTicks, int16_t rightTicks) {
+        // Unsigned subtraction is well defined across the int16 wraparound.
+        const int16_t deltaLeft = static_cast<uint16_t>(leftTicks) - static_cast<uint16_t>(prevLeft);
+        const int16_t deltaRight = static_cast<uint16_t>(rightTicks) - static_cast<uint16_t>(prevRight);
+        prevLeft = leftTicks;
+        prevRight = rightTicks;
+
+        // Heading arithmetic is modulo a full turn, so unsigned overflow is exactly what we want.
+        const uint32_t deltaDifference = static_cast<uint32_t>(static_cast<int32_t>(deltaRight) - deltaLeft);
+        const uint32_t midHeading = heading + deltaDifference * (headingPerTick >> 1);
+        heading += deltaDifference * headingPerTick;
+        encoderHeading = heading;
+
+        // Average forward distance, rounded to Q8 millimetres.
+        const int32_t deltaCenter =
+                ((static_cast<int32_t>(deltaLeft) + deltaRight) * mmPerHalfTickQ16 + 128) >> 8;
+        distance += deltaCenter;
+
+        const FixedTrig::BinaryAngle angle = midHeading >> 16;
+        x += FixedTrig::mulQ15(deltaCenter, FixedTrig::cosQ15(angle));
+        y -= FixedTrig::mulQ15(deltaCenter, FixedTrig::sinQ15(angle));
+    }
+
+    /**
+     * Converts a Q8 fixed-point millimetre value to millimetres.
+     *
+     * @param q8 Value in 1/256 mm.
+     * @return The value in millimetres.
+     */
+    static double toMillimetres(int32_t q8) {
+        return q8 / 256.0;
+    }
+
+    /**
+     * Gets the current x position in Q8 fixed-point millimetres.
+     */
+    int32_t getXQ8() const {
+        return x;
+    }
+
+    /**
+     * Gets the current y position in Q8 fixed-point millimetres.
+     */
+    int32_t getYQ8() const {
+        return y;
+    }
+
+    /**
+     * Gets the distance travelled since the last reset in Q8 fixed-point
+     * millimetres. Driving backward subtracts; spinning in place adds nothing.
+     */
+    int32_t getDistanceQ8() const {
+        return distance;
+    }
+
+    /**
+     * Gets the current heading as a wrapped binary angle (65536 per turn).
+     */
+    FixedTrig::BinaryAngle getHeading() const {
+        return heading >> 16;
+    }
+
+    /**
+     * Gets the heading from the wheel difference alone, without the gyro
+     * (65536 per turn). It follows the path's curvature, slip included.
+     */
+    FixedTrig::BinaryAngle getEncoderHeading() const {
+        return encoderHeading >> 16;
+    }
+
+    /**
+     * Gets the current x position of the robot.
+     *
+     * @return The x position in millimeters.
+     */
+    double getX() const {
+        return toMillimetres(x);
+    }
+
+    /**
+     * Gets the current y position of the robot.
+     *
+     * @return The y position in millimeters.
+     */
+    double getY() const {
+        return toMillimetres(y);
+    }
+
+    /**
+     * Gets the current orientation of the robot.
+     *
+     * @return The orientation (theta) in radians, in [-π, π).
+     */
+    double getTheta() const {
+        return FixedTrig::toRadians(getHeading());
+    }
+
+    /**
+     * Gets the current pose (x, y, theta) of the robot.
+     *
+     * @return A Pose structure containing the robot's position and orientation.
+     */
+    Pose getPose() const {
+        return {getX(), getY(), getTheta()};
+    }
+};
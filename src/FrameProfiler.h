@@ -0,0 +1,167 @@
+/*
+ * File: FrameProfiler.h
+ *
+ * Description:
+ * This file implements the FrameProfiler class, which keeps run-time
+ * statistics of the game loop stages in microseconds: the minimum, maximum
+ * and mean of each stage, and a histogram with power-of-two buckets. The
+ * statistics take a fixed 28 bytes per stage, so the whole loop is profiled
+ * in a few hundred bytes. FrameScheduler feeds it when FRAME_PROFILER is set.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+
+/**
+ * Run-time statistics of a fixed set of stages.
+ *
+ * Histogram bucket 0 counts runs shorter than 2^PROFILER_BUCKET_SHIFT µs;
+ * each following bucket doubles the limit, and the last bucket counts
+ * everything longer.
+ *
+ * @tparam Stages Number of profiled stages.
+ */
+template<uint8_t Stages>
+class FrameProfiler {
+private:
+    struct Stage {
+        uint16_t min;                          // Shortest run (µs).
+        uint16_t max;                          // Longest run (µs).
+        uint32_t sum;                          // Total run time (µs).
+        uint32_t count;                        // Number of runs.
+        uint16_t buckets[PROFILER_BUCKETS];    // Runs per duration bucket.
+    };
+
+    Stage stages[Stages];                      // Statistics, indexed by stage.
+
+public:
+    /**
+     * Constructor for the FrameProfiler.
+     */
+    FrameProfiler() {
+        reset();
+    }
+
+    /**
+     * Clears all statistics.
+     */
+    void reset() {
+        for (uint8_t i = 0; i < Stages; i++) {
+            stages[i].min = 0xFFFF;
+            stages[i].max = 0;
+            stages[i].sum = 0;
+            stages[i].count = 0;
+            for (uint8_t b = 0; b < PROFILER_BUCKETS; b++) {
+                stages[i].buckets[b] = 0;
+            }
+        }
+    }
+
+    /**
+     * Records one run of a stage.
+     *
+     * @param stage The stage.
+     * @param time Its run time (µs).
+     */
+    void record(uint8_t stage, microseconds time) {
+        Stage &s = stages[stage];
+        const uint16_t clipped = time > 0xFFFF ? 0xFFFF : time;
+        if (clipped < s.min) {
+            s.min = clipped;
+        }
+        if (clipped > s.max) {
+            s.max = clipped;
+        }
+        s.sum += time;
+        s.count += 1;
+
+        uint8_t bucket = 0;
+        for (microseconds rest = time >> PROFILER_BUCKET_SHIFT; rest != 0 && bucket < PROFILER_BUCKETS - 1; rest >>= 1) {
+            bucket += 1;
+        }
+        if (s.buckets[bucket] != 0xFFFF) {
+            s.buckets[bucket] += 1;
+        }
+    }
+
+    /**
+     * @return The number of recorded runs of a stage.
+     */
+    uint32_t getCount(uint8_t stage) const {
+        return stages[stage].count;
+    }
+
+    /**
+     * @return The shortest run of a stage (µs), 0 if it never ran.
+     */
+    uint16_t getMin(uint8_t stage) const {
+        return stages[stage].count ? stages[stage].min : 0;
+    }
+
+    /**
+     * @return The longest run of a stage (µs).
+     */
+    uint16_t getMax(uint8_t stage) const {
+        return stages[stage].max;
+    }
+
+    /**
+     * @return The mean run time of a stage (µs), 0 if it never ran.
+     */
+    uint32_t getMean(uint8_t stage) const {
+        return stages[stage].count ? stages[stage].sum / stages[stage].count : 0;
+    }
+
+    /**
+     * @return The number of runs of a stage in a histogram bucket.
+     */
+    uint16_t getBucket(uint8_t stage, uint8_t bucket) const {
+        return stages[stage].buckets[bucket];
+    }
+
+    /**
+     * @return The upper limit of a histogram bucket (µs); the last bucket has none.
+     */
+    static uint32_t bucketLimit(uint8_t bucket) {
+        return (1UL << PROFILER_BUCKET_SHIFT) << bucket;
+    }
+
+    /**
+     * Prints the statistics as a table, one row per stage, e.g. to Serial
+     * over USB. The histogram columns are headed by their upper limits.
+     *
+     * @param out Anything with Arduino's print()/println().
+     * @param names The name of each stage.
+     */
+    template<typename Output>
+    void printSummary(Output &out, const char *const names[]) const {
+        out.print("stage,runs,min_us,mean_us,max_us");
+        for (uint8_t b = 0; b < PROFILER_BUCKETS - 1; b++) {
+            out.print(",<");
+            out.print(static_cast<long>(bucketLimit(b)));
+        }
+        out.print(",>=");
+        out.println(static_cast<long>(bucketLimit(PROFILER_BUCKETS - 2)));
+
+        for (uint8_t i = 0; i < Stages; i++) {
+            out.print(names[i]);
+            out.print(",");
+            out.print(static_cast<long>(getCount(i)));
+            out.print(",");
+            out.print(static_cast<long>(getMin(i)));
+            out.print(",");
+            out.print(static_cast<long>(getMean(i)));
+            out.print(",");
+            out.print(static_cast<long>(getMax(i)));
+            for (uint8_t b = 0; b < PROFILER_BUCKETS; b++) {
+                out.print(",");
+                out.print(static_cast<long>(getBucket(i, b)));
+            }
+            out.println();
+        }
+    }
+};
@@ -0,0 +1,263 @@
+/*
+ * File: FrameScheduler.h
+ *
+ * Description:
+ * This file implements the FrameScheduler class, which runs the game loop
+ * at a fixed frame rate. Tasks register with a period (in frames), a
+ * priority and a time budget. Each frame starts on a fixed deadline; due
+ * foreground tasks always run, in priority order, while background tasks
+ * only run if the slack left before the next deadline covers their budget.
+ * Tasks that exceed their budget, and frames that miss their deadline, are
+ * counted so the timing can be checked after a run. With FRAME_PROFILER
+ * set, every task run and the busy part of every frame are also recorded in
+ * a FrameProfiler.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "Clock.h"
+#if FRAME_PROFILER
+#include "FrameProfiler.h"
+#endif
+
+// Enumerates the game loop tasks.
+typedef enum Task {
+    ScanTask,                // Read the IR and bump sensors.
+    FollowTask,              // Line-following controller.
+    OdometryTask,            // Fuse the encoders and gyro into the pose.
+    MotionTask,              // Step turns and holds.
+    EventTask,               // Dispatch pending events.
+    MissionTask,             // Resume mission coroutines.
+    CollisionTask,           // Collision detection, recovery and the end condition.
+    AnomalyTask,             // Magnetic anomaly detection.
+    NUMBER_OF_TASKS          // The total number of tasks (must remain last).
+} Task;
+
+typedef void (*TaskCallback)(); // Function pointer for task bodies.
+
+#if FRAME_PROFILER
+#define FRAME_STAGE NUMBER_OF_TASKS                    // Profiler stage of the whole frame's work.
+#define NUMBER_OF_PROFILER_STAGES (NUMBER_OF_TASKS + 1)
+#endif
+
+/*
+ * Runs registered tasks against a fixed frame deadline.
+ */
+class FrameScheduler {
+    struct Slot {
+        TaskCallback callback = nullptr; // Task body; unregistered tasks never run.
+        uint8_t period = 1;              // Runs every `period` frames.
+        uint8_t priority = 0;            // Lower runs first; >= SCHEDULER_BACKGROUND_PRIORITY is background.
+        uint16_t budget = 0;             // Expected run time (µs).
+        uint16_t overruns = 0;           // Runs that exceeded the budget.
+        uint16_t skipped = 0;            // Background runs skipped for lack of slack.
+        uint16_t worst = 0;              // Longest run time seen (µs).
+    };
+
+    struct Slot slots[NUMBER_OF_TASKS];  // Task table, indexed by Task.
+    uint8_t order[NUMBER_OF_TASKS];      // Task indices sorted by priority.
+    const microseconds framePeriod;      // Frame length (µs).
+    microseconds deadline = 0;           // End of the current frame (µs).
+    microseconds startTime = 0;          // Start of the first frame (µs).
+    uint32_t frames = 0;                 // Frames run since begin().
+    uint16_t missedFrames = 0;           // Frames that ran past their deadline.
+    bool running = false;                // Cleared by stop().
+#if FRAME_PROFILER
+    FrameProfiler<NUMBER_OF_PROFILER_STAGES> profiler; // Task and frame run times.
+#endif
+
+public:
+    /*
+     * Constructor for the FrameScheduler.
+     *
+     * framePeriod: Frame length in microseconds.
+     */
+    explicit FrameScheduler(microseconds framePeriod = MILLISECONDS_PER_FRAME * 1000UL) : framePeriod(framePeriod) {
+        for (uint8_t i = 0; i < NUMBER_OF_TASKS; i++) {
+            order[i] = i;
+        }
+    }
+
+    /*
+     * Registers a task.
+     *
+     * task: The task slot.
+     * period: Run every `period` frames.
+     * priority: Lower runs first; SCHEDULER_BACKGROUND_PRIORITY and above only run in slack.
+     * budget: Expected run time in microseconds.
+     * callback: The task body.
+     */
+    void addTask(Task task, uint8_t period, uint8_t priority, uint16_t budget, TaskCallback callback) {
+        slots[task].callback = callback;
+        slots[task].period = period ? period : 1;
+        slots[task].priority = priority;
+        slots[task].budget = budget;
+
+        // Insertion sort, stable for equal priorities.
+        for (uint8_t i = 1; i < NUMBER_OF_TASKS; i++) {
+            const uint8_t index = order[i];
+            uint8_t j = i;
+            while (j > 0 && slots[order[j - 1]].priority > slots[index].priority) {
+                order[j] = order[j - 1];
+                j -= 1;
+            }
+            order[j] = index;
+        }
+    }
+
+    /*
+     * Starts a run: clears the statistics and sets the first deadline.
+     */
+    void begin() {
+        for (uint8_t i = 0; i < NUMBER_OF_TASKS; i++) {
+            slots[i].overruns = 0;
+            slots[i].skipped = 0;
+            slots[i].worst = 0;
+        }
+        frames = 0;
+        missedFrames = 0;
+#if FRAME_PROFILER
+        profiler.reset();
+#endif
+        running = true;
+        startTime = Clock::now();
+        deadline = startTime;
+    }
+
+    /*
+     * Ends the run after the current frame. Callable from a task.
+     */
+    void stop() {
+        running = false;
+    }
+
+    /*
+     * Waits for the next frame and runs its due tasks.
+     *
+     * returns: False once the run has been stopped.
+     */
+    bool runFrame() {
+        if (!running) {
+            return false;
+        }
+
+        // Idle until the frame starts. A frame more than a period late
+        // starts now instead of running a burst of short frames to catch up.
+        const int32_t late = static_cast<int32_t>(Clock::now() - deadline);
+        if (late > 0 && frames > 0) {
+            missedFrames += 1;
+        }
+        while (static_cast<int32_t>(Clock::now() - deadline) < 0) {}
+        if (late >= static_cast<int32_t>(framePeriod)) {
+            deadline = Clock::now();
+        }
+        deadline += framePeriod;
+#if FRAME_PROFILER
+        const microseconds frameStart = Clock::now();
+#endif
+
+        for (uint8_t i = 0; i < NUMBER_OF_TASKS && running; i++) {
+            Slot &slot = slots[order[i]];
+            if (slot.callback == nullptr || frames % slot.period != 0) {
+                continue;
+            }
+            if (slot.priority >= SCHEDULER_BACKGROUND_PRIORITY && remaining() < slot.budget) {
+                slot.skipped += 1;
+                continue;
+            }
+
+            const microseconds taskStart = Clock::now();
+            slot.callback();
+            const microseconds taskTime = Clock::now() - taskStart;
+
+            if (taskTime > slot.budget) {
+                slot.overruns += 1;
+            }
+            if (taskTime > slot.worst) {
+                slot.worst = taskTime > 0xFFFF ? 0xFFFF : taskTime;
+            }
+#if FRAME_PROFILER
+            profiler.record(order[i], taskTime);
+#endif
+        }
+#if FRAME_PROFILER
+        profiler.record(FRAME_STAGE, Clock::now() - frameStart);
+#endif
+
+        frames += 1;
+        return running;
+    }
+
+    /*
+     * Returns the time left before the current frame's deadline (µs), 0 if past it.
+     */
+    microseconds remaining() const {
+        const int32_t left = static_cast<int32_t>(deadline - Clock::now());
+        return left > 0 ? left : 0;
+    }
+
+    /*
+     * Returns the number of runs of a task that exceeded its budget.
+     */
+    uint16_t getOverruns(Task task) const {
+        return slots[task].overruns;
+    }
+
+    /*
+     * Returns the number of times a background task was skipped for lack of slack.
+     */
+    uint16_t getSkipped(Task task) const {
+        return slots[task].skipped;
+    }
+
+    /*
+     * Returns the longest run time of a task (µs).
+     */
+    uint16_t getWorst(Task task) const {
+        return slots[task].worst;
+    }
+
+    /*
+     * Returns the number of frames that ran past their deadline.
+     */
+    uint16_t getMissedFrames() const {
+        return missedFrames;
+    }
+
+    /*
+     * Returns the number of frames run since begin().
+     */
+    uint32_t getFrames() const {
+        return frames;
+    }
+
+    /*
+     * Returns the time since begin() (µs).
+     */
+    microseconds getElapsed() const {
+        return Clock::now() - startTime;
+    }
+
+#if FRAME_PROFILER
+    /*
+     * Returns the run-time statistics of the last run, indexed by Task,
+     * with the whole frame's work at FRAME_STAGE.
+     */
+    const FrameProfiler<NUMBER_OF_PROFILER_STAGES> &getProfiler() const {
+        return profiler;
+    }
+
+    /*
+     * Returns a short name for each profiler stage, for the summary table.
+     */
+    static const char *const *getStageNames() {
+        static const char *const names[NUMBER_OF_PROFILER_STAGES] = {
+            "Scan", "Follow", "Odom", "Motion", "Event", "Mission", "Collide", "Anomaly", "Frame"
+        };
+        return names;
+    }
+#endif
+};
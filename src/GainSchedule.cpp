@@ -0,0 +1,57 @@
+/*
+ * File: GainSchedule.cpp
+ *
+ * Description:
+ * This file implements the `GainSchedule` namespace and generates its
+ * table. Up to GAIN_REFERENCE_SPEED, the speed the PID constants were
+ * tuned at, the gains are the PID constants. Above it they fall as
+ * sqrt(GAIN_REFERENCE_SPEED / speed): the lateral error responds to
+ * steering in proportion to speed, so fixed gains grow sharper and less
+ * damped as the robot speeds up, while a fixed frame delay calls for a
+ * gentler loop. The square root splits the difference; adjust the
+ * profile below and the table follows.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include "GainSchedule.h"
+#include "IntegerMath.h"
+
+/*
+ * Gain scale at a speed (mm/s), * 256.
+ */
+static constexpr int32_t profile(int32_t speed) {
+    return speed <= GAIN_REFERENCE_SPEED ? 256 : IntegerMath::isqrt((static_cast<uint32_t>(GAIN_REFERENCE_SPEED) << 16) / speed);
+}
+
+/*
+ * Gains at a speed (mm/s).
+ */
+static constexpr GainSchedule::Gains gainsAt(int32_t speed) {
+    return {
+            static_cast<int16_t>(PROPORTIONAL_CONSTANT * profile(speed) >> 8),
+            static_cast<int16_t>(INTEGRAL_CONSTANT * profile(speed) >> 8),
+            static_cast<int16_t>(DERIVATIVE_CONSTANT * profile(speed) >> 8),
+    };
+}
+
+#define GAIN_POINT(i) gainsAt(static_cast<int32_t>(i) << GAIN_SCHEDULE_SHIFT)
+
+/*
+ * Gains every 2^GAIN_SCHEDULE_SHIFT mm/s, from 0.
+ */
+static const GainSchedule::Gains gainTable[] PROGMEM = {
+        GAIN_POINT(0), GAIN_POINT(1), GAIN_POINT(2), GAIN_POINT(3), GAIN_POINT(4),
+        GAIN_POINT(5), GAIN_POINT(6), GAIN_POINT(7), GAIN_POINT(8),
+};
+
+static_assert(sizeof(gainTable) / sizeof(gainTable[0]) == GAIN_SCHEDULE_POINTS,
+              "gainTable needs one GAIN_POINT per GAIN_SCHEDULE_POINTS");
+
+/*
+ * Looks up the gains for a speed (mm/s).
+ */
+GainSchedule::Gains GainSchedule::lookup(int16_t speed) {
+    return interpolateRow(gainTable, speed);
+}
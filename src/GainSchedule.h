@@ -0,0 +1,76 @@
+/*
+ * File: GainSchedule.h
+ *
+ * Description:
+ * This header file declares the `GainSchedule` namespace, which picks the
+ * line-following PID gains for the robot's current speed. The gains are
+ * kept in a PROGMEM table with one entry every 2^GAIN_SCHEDULE_SHIFT mm/s,
+ * computed at compile time from a constexpr speed profile, and linearly
+ * interpolated between entries, so a lookup costs two table reads and a
+ * few multiplies. The interpolation is a template shared with the
+ * `LineController` table.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+
+namespace GainSchedule {
+
+    /**
+     * PID gains, in the units of `PidController`.
+     */
+    struct Gains {
+        int16_t kp;                      // Proportional gain * 256.
+        int16_t ki;                      // Integral gain per nominal period * 256.
+        int16_t kd;                      // Derivative gain per nominal period * 256.
+    };
+
+    /**
+     * Looks up the gains for a speed.
+     *
+     * @param speed Forward speed (mm/s); negative speeds use the gains for 0.
+     * @return The interpolated gains.
+     */
+    Gains lookup(int16_t speed);
+
+    /**
+     * Interpolates a row of a PROGMEM table with GAIN_SCHEDULE_POINTS rows,
+     * one every 2^GAIN_SCHEDULE_SHIFT mm/s from 0. Rows are structs of
+     * int16_t fields, each interpolated on its own.
+     *
+     * @param table The table, in PROGMEM.
+     * @param speed Forward speed (mm/s); negative speeds use the row for 0,
+     *              speeds past the table its last row.
+     * @return The interpolated row.
+     */
+    template<typename Row>
+    Row interpolateRow(const Row *table, int16_t speed) {
+        static_assert(sizeof(Row) % sizeof(int16_t) == 0, "table rows must be made of int16_t fields");
+
+        if (speed < 0) {
+            speed = 0;
+        }
+        uint8_t index = speed >> GAIN_SCHEDULE_SHIFT;
+        uint16_t fraction = speed & ((1 << GAIN_SCHEDULE_SHIFT) - 1);
+        if (index >= GAIN_SCHEDULE_POINTS - 1) {
+            index = GAIN_SCHEDULE_POINTS - 1;
+            fraction = 0;
+        }
+
+        const int16_t *entry = reinterpret_cast<const int16_t *>(&table[index]);
+        const int16_t *next = reinterpret_cast<const int16_t *>(&table[fraction ? index + 1 : index]);
+        Row row;
+        int16_t *fields = reinterpret_cast<int16_t *>(&row);
+        for (uint8_t i = 0; i < sizeof(Row) / sizeof(int16_t); i++) {
+            const int16_t value = pgm_read_word(entry + i);
+            fields[i] = fraction == 0 ? value :
+                    value + ((static_cast<int32_t>(static_cast<int16_t>(pgm_read_word(next + i)) - value) * fraction)
+                            >> GAIN_SCHEDULE_SHIFT);
+        }
+        return row;
+    }
+}
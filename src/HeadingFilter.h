@@ -0,0 +1,138 @@
+/*
+ * File: HeadingFilter.h
+ *
+ * Description:
+ * This file defines the `HeadingFilter` class, a fixed-point complementary
+ * filter that fuses the z-gyro with the encoder heading. The gyro drives
+ * the heading; the encoder heading slowly pulls it back so gyro drift stays
+ * bounded. When the two disagree by more than a slip threshold in a single
+ * update, the encoder reference is re-anchored to the gyro, so wheel slip
+ * never enters the heading. The gyro bias is re-estimated online with
+ * zero-velocity updates whenever the robot is standing still.
+ *
+ * Angles use the same convention as the encoder ISRs: 2^32 is a full
+ * counter-clockwise turn.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+
+/**
+ * Class for fusing gyro rate and encoder heading into one heading estimate.
+ */
+class HeadingFilter {
+private:
+    uint32_t heading;                    // Fused heading (2^32 per turn).
+    uint32_t prevEncoder;                // Encoder heading at the previous update.
+    int32_t encoderOffset;               // Slip absorbed so far (added to the encoder heading).
+    int32_t bias;                        // Gyro bias estimate (digits * 256).
+    uint8_t stillUpdates;                // Consecutive updates with both wheels stopped.
+    uint16_t slips;                      // Number of updates rejected as slip.
+
+public:
+    /**
+     * Constructor to initialize an aligned, zero-bias filter.
+     */
+    HeadingFilter() : bias(0) {
+        reset(0);
+    }
+
+    /**
+     * Resets the fused heading to the encoder heading and forgets the slip
+     * history. The bias estimate is kept, it does not depend on the pose.
+     *
+     * @param encoderHeading Current encoder heading (2^32 per turn).
+     */
+    void reset(uint32_t encoderHeading) {
+        heading = encoderHeading;
+        prevEncoder = encoderHeading;
+        encoderOffset = 0;
+        stillUpdates = 0;
+        slips = 0;
+    }
+
+    /**
+     * Clears the gyro bias estimate.
+     */
+    void resetBias() {
+        bias = 0;
+    }
+
+    /**
+     * Runs one filter step.
+     *
+     * @param encoderHeading Current encoder heading (2^32 per turn).
+     * @param wheelsStopped True if neither wheel has ticked since the previous update.
+     * @param gyroRate Calibrated z-gyro reading (0.07 dps per digit).
+     * @param dtMicros Time since the previous update (µs).
+     */
+    void update(uint32_t encoderHeading, bool wheelsStopped, int16_t gyroRate, uint32_t dtMicros) {
+        const int32_t deltaEncoder = encoderHeading - prevEncoder;
+        prevEncoder = encoderHeading;
+
+        // Zero-velocity update: a robot that has not moved for a while has a true rate of 0.
+        // An unchanged encoder heading is not enough, driving straight keeps it too.
+        if (wheelsStopped) {
+            if (stillUpdates < HEADING_STILL_UPDATES) {
+                stillUpdates += 1;
+            }
+        } else {
+            stillUpdates = 0;
+        }
+        const bool still = stillUpdates >= HEADING_STILL_UPDATES;
+        if (still) {
+            bias += ((static_cast<int32_t>(gyroRate) << 8) - bias) >> HEADING_BIAS_SHIFT;
+        }
+
+        // One gyro sample can't stand for a long gap (a blocking turn); fall back to the encoders.
+        if (dtMicros > HEADING_MAX_DT_US) {
+            heading += deltaEncoder;
+            return;
+        }
+
+        // Gyro increment in turn units: rate (digits * 256) * dt (µs) * GYRO_TURN_PER_DIGIT_US_Q24 / 2^32.
+        const int32_t rate = (static_cast<int32_t>(gyroRate) << 8) - bias;
+        const int32_t deltaGyro = still ? 0 :
+                static_cast<int32_t>((static_cast<int64_t>(rate) * dtMicros * GYRO_TURN_PER_DIGIT_US_Q24) >> 32);
+
+        // A large disagreement means the wheels slipped; keep the gyro's view.
+        const int32_t residual = deltaEncoder - deltaGyro;
+        if (residual > HEADING_SLIP_THRESHOLD || residual < -HEADING_SLIP_THRESHOLD) {
+            encoderOffset -= residual;
+            slips += 1;
+        }
+
+        heading += deltaGyro;
+        const int32_t correction = (encoderHeading + encoderOffset) - heading;
+        heading += correction >> HEADING_BLEND_SHIFT;
+    }
+
+    /**
+     * Gets the fused heading.
+     *
+     * @return The heading, 2^32 per counter-clockwise turn.
+     */
+    uint32_t getHeading() const {
+        return heading;
+    }
+
+    /**
+     * Gets the current gyro bias estimate.
+     *
+     * @return The bias in gyro digits * 256.
+     */
+    int32_t getBias() const {
+        return bias;
+    }
+
+    /**
+     * Gets the number of updates rejected as wheel slip since the last reset.
+     */
+    uint16_t getSlips() const {
+        return slips;
+    }
+};
@@ -12,11 +12,13 @@
  */
 
 #include "IRSensor.h"
+#include "Clock.h"
 
 
 // Constants for the maximum number of sensors and dots.
 #define MAX_SIGN_DOTS 5
 #define NUM_IRSENSORS 5
+#define MAX_SUBSCRIPTIONS 4
 
 /*
  * Enum to represent the positions of IR sensors on the robot.
@@ -45,34 +47,34 @@ static uint16_t lineSensorValues[NUM_IRSENSORS];
  */
 class Scanner {
 public:
-    Scanner() : state(WHITE), t0(millis()) {}
+    Scanner() : state(WHITE), t0(Clock::now()) {}
 
     /*
      * Detects transitions between black and white regions.
-     * Returns the duration of detected black bars (in milliseconds).
+     * Returns the duration of detected black bars (in microseconds).
      */
-    Option<milliseconds> scan(const bool blackDetected) {
+    Option<microseconds> scan(const bool blackDetected) {
         switch (this->state) {
             case WHITE: {
                 if (blackDetected) {
                     this->state = BLACK;
-                    this->t0 = millis(); // Start timestamp for black region.
-                    return Option<milliseconds>();
+                    this->t0 = Clock::now(); // Start timestamp for black region.
+                    return Option<microseconds>();
                 }
                 break;
             }
             case BLACK: {
                 if (!blackDetected) {
                     this->state = WHITE;
-                    const uint64_t t1 = millis();
-                    const uint64_t delta = t1 - t0; // Calculate duration.
+                    const microseconds t1 = Clock::now();
+                    const microseconds delta = t1 - t0; // Calculate duration.
                     this->t0 = t1;
-                    return Option<milliseconds>(delta);
+                    return Option<microseconds>(delta);
                 }
                 break;
             }
         }
-        return Option<milliseconds>(); // No new value detected.
+        return Option<microseconds>(); // No new value detected.
     }
 
 private:
@@ -85,7 +87,7 @@ private:
     } ReadingState;
 
     ReadingState state; // Current detection state.
-    milliseconds t0;    // Timestamp of the current state.
+    microseconds t0;    // Timestamp of the current state (µs).
 };
 
 /*
@@ -117,6 +119,54 @@ private:
 SignScanner<IRSensorAtLocation::LEFT> leftScanner;
 SignScanner<IRSensorAtLocation::RIGHT> rightScanner;
 
+/*
+ * A predicate on a sensor source and the event sent on its rising edge.
+ */
+struct Subscription {
+    uint8_t source;      // IRSensor::SensorSource being watched.
+    uint8_t threshold;   // The predicate is `value >= threshold`.
+    uint8_t event;       // Event sent on the rising edge.
+    bool held;           // Predicate value at the previous scan.
+};
+
+static Subscription subscriptions[MAX_SUBSCRIPTIONS];
+static uint8_t subscriptionCount = 0;
+static IRSensor::SensorSink subscriptionSink = nullptr;
+
+/*
+ * Returns the current value of a sensor source.
+ */
+static unsigned int sourceValue(uint8_t source) {
+    switch (source) {
+        case IRSensor::LeftDots:
+            return leftScanner.getCounts();
+        case IRSensor::RightDots:
+            return rightScanner.getCounts();
+        case IRSensor::LineLost:
+            return lineSensorValues[MIDDLE_LEFT] <= NOISE_THRESHOLD &&
+                   lineSensorValues[CENTER] <= NOISE_THRESHOLD &&
+                   lineSensorValues[MIDDLE_RIGHT] <= NOISE_THRESHOLD;
+        case IRSensor::Bumped:
+            return IRSensor::isCollisionDetected();
+    }
+    return 0;
+}
+
+/*
+ * Evaluates every subscription once and sends the events whose
+ * predicate has just become true.
+ */
+static void notifySubscribers() {
+    for (uint8_t i = 0; i < subscriptionCount; i++) {
+        Subscription &subscription = subscriptions[i];
+        const bool holds = sourceValue(subscription.source) >= subscription.threshold;
+        if (holds && !subscription.held && subscriptionSink != nullptr) {
+            subscriptionSink(Event(subscription.event));
+        }
+        subscription.held = holds;
+    }
+}
+
 /*
  * Initializes the IR sensors by setting their timeout
  * and calibrating the bump sensors.
@@ -126,6 +176,37 @@ void IRSensor::initializeIR() {
     bumpSensors.calibrate();
 }
 
+/*
+ * Sets the function that receives subscription events.
+ */
+void IRSensor::setSubscriptionSink(SensorSink sink) {
+    subscriptionSink = sink;
+}
+
+/*
+ * Subscribes an event to the predicate `source >= threshold`.
+ */
+void IRSensor::subscribe(SensorSource source, uint8_t threshold, Event event) {
+    uint8_t i = 0;
+    while (i < subscriptionCount && subscriptions[i].event != event) {
+        i += 1;
+    }
+    if (i == MAX_SUBSCRIPTIONS) {
+        return;
+    }
+    if (i == subscriptionCount) {
+        subscriptionCount += 1;
+    }
+    subscriptions[i] = {static_cast<uint8_t>(source), threshold, static_cast<uint8_t>(event), false};
+}
+
+/*
+ * Removes every subscription.
+ */
+void IRSensor::clearSubscriptions() {
+    subscriptionCount = 0;
+}
+
 /*
  * Resets the detection history of the left path sign scanner.
  */
@@ -183,6 +264,7 @@ void IRSensor::scan() {
     bumpSensors.read();
     leftScanner.scan();
     rightScanner.scan();
+    notifySubscribers();
 }
 
 /*
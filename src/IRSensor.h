@@ -14,6 +14,7 @@
 #pragma once
 
 #include "RATS.h"
+#include "EventManager.h"
 
 namespace IRSensor {
 
@@ -31,6 +32,53 @@ namespace IRSensor {
 
     typedef unsigned int Dots; // Represents the count of detected dots.
 
+    /*
+     * Sensor values that subscriptions can watch.
+     */
+    typedef enum SS {
+        LeftDots,                // Dots counted by the left scanner.
+        RightDots,               // Dots counted by the right scanner.
+        LineLost,                // 1 while none of the middle sensors see anything.
+        Bumped,                  // 1 while both bump sensors are pressed.
+        NUMBER_OF_SENSOR_SOURCES // The total number of sources (must remain last).
+    } SensorSource;
+
+    typedef void (*SensorSink)(Event event); // Receives the events of triggered subscriptions.
+
+    /*
+     * Sets the function that receives subscription events, e.g. one that
+     * fires them on the event manager.
+     */
+    void setSubscriptionSink(SensorSink sink);
+
+    /*
+     * Subscribes an event to a sensor predicate: `source >= threshold`.
+     * The predicate is evaluated once per scan() and the event is sent on
+     * its rising edge only. Re-subscribing an event replaces its predicate.
+     * A predicate that already holds triggers on the next scan.
+     *
+     * source: The sensor value to watch.
+     * threshold: Value at which the predicate becomes true.
+     * event: The event to send.
+     */
+    void subscribe(SensorSource source, uint8_t threshold, Event event);
+
+    /*
+     * Subscribes with a threshold checked at compile time.
+     */
+    template<SensorSource Source, uint8_t Threshold>
+    void subscribe(Event event) {
+        static_assert(Source < NUMBER_OF_SENSOR_SOURCES, "unknown sensor source");
+        static_assert(Threshold > 0, "a zero threshold is always true");
+        static_assert(Source == LeftDots || Source == RightDots || Threshold == 1, "flag sources only take 1");
+        subscribe(Source, Threshold, event);
+    }
+
+    /*
+     * Removes every subscription.
+     */
+    void clearSubscriptions();
+
     /*
      * Initializes the IR sensors and the bump sensors.
      * - Sets the timeout for IR sensors.
@@ -48,6 +96,7 @@ namespace IRSensor {
      * Reads and updates the calibrated IR sensor values.
      * - Also updates bump sensor readings.
      * - Used for real-time scanning during navigation.
+     * - Evaluates the subscriptions once against the new readings.
      */
     void scan();
 
@@ -10,7 +10,8 @@
  * This file defines the InertialMeasurementUnit class, which provides
  * calibration and data processing for accelerometer and magnetometer
  * sensors. It includes methods for detecting magnetic anomalies, 
- * calculating orientation (pitch and roll), and handling sensor offsets.
+ * calculating orientation (pitch and roll), reading the yaw rate and the
+ * forward acceleration, and handling sensor offsets.
  *
  * Author: OCdt Gratton
  * Version: 2024-12-01
@@ -23,6 +24,8 @@ private:
     float zOffset;       // Calibration offset for z-axis magnetic field.
     float pitchOffset;   // Calibration offset for pitch angle.
     float rollOffset;    // Calibration offset for roll angle.
+    int16_t gyroOffset;  // Calibration offset for the z-axis gyro.
+    int16_t accelOffset; // Calibration offset for the x-axis accelerometer.
 
 public:
     Pololu3piPlus32U4::IMU myIMU; // IMU sensor object to interface with hardware.
@@ -32,7 +35,7 @@ public:
      */
     IntertialMeasurementUnit()
             : xOffset(0.0), yOffset(0.0), zOffset(0.0),
-              pitchOffset(0.0), rollOffset(0.0) {}
+              pitchOffset(0.0), rollOffset(0.0), gyroOffset(0), accelOffset(0) {}
 
     /*
      * Calibrates the IMU by reading magnetometer and accelerometer data.
@@ -47,6 +50,9 @@ public:
         yOffset = myIMU.m.y;
         zOffset = myIMU.m.z;
 
+        // Record the x-axis accelerometer offset (gravity on a tilted board).
+        accelOffset = myIMU.a.x;
+
         // Calculate normalized accelerometer values.
         float accelX = myIMU.a.x;
         float accelY = myIMU.a.y;
@@ -59,6 +65,33 @@ public:
         // Compute pitch and roll offsets.
         pitchOffset = calculatePitch(normX, normY, normZ);
         rollOffset = calculateRoll(normX, normY, normZ);
+
+        // Average the stationary z-gyro reading for its offset.
+        int32_t gyroSum = 0;
+        for (uint8_t i = 0; i < GYRO_CALIBRATION_SAMPLES; i++) {
+            while (!myIMU.gyroDataReady()) {}
+            myIMU.readGyro();
+            gyroSum += myIMU.g.z;
+        }
+        gyroOffset = gyroSum / GYRO_CALIBRATION_SAMPLES;
+    }
+
+    /*
+     * Reads the z-axis gyro and returns the calibrated yaw rate
+     * (0.07 dps per digit, counter-clockwise positive).
+     */
+    int16_t readYawRate() {
+        myIMU.readGyro(); // Read gyro data.
+        return myIMU.g.z - gyroOffset;
+    }
+
+    /*
+     * Reads the x-axis accelerometer and returns the calibrated forward
+     * acceleration of the body (mm/s², +x points forward).
+     */
+    int16_t readForwardAcceleration() {
+        myIMU.readAcc(); // Read accelerometer data.
+        return (static_cast<int32_t>(myIMU.a.x - accelOffset) * ACCEL_MM_S2_PER_DIGIT_Q10) >> 10;
     }
 
     /*
@@ -0,0 +1,40 @@
+/*
+ * File: IntegerMath.h
+ *
+ * Description:
+ * This file defines the `IntegerMath` namespace, integer helpers shared by
+ * the controllers. They are constexpr, so the same code generates tables
+ * at compile time (see `GainSchedule`) and runs once per frame (see
+ * `MotionProfile`).
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace IntegerMath {
+
+    /*
+     * One digit of isqrt(): `bit` walks down the even powers of two,
+     * building the root in `root` as n is used up. A single return keeps
+     * it a C++11 constant expression; at run time the tail call is a loop.
+     */
+    constexpr uint32_t isqrtStep(uint32_t n, uint32_t root, uint32_t bit) {
+        return bit == 0 ? root
+                        : n >= root + bit ? isqrtStep(n - (root + bit), (root >> 1) + bit, bit >> 2)
+                                          : isqrtStep(n, root >> 1, bit >> 2);
+    }
+
+    /**
+     * Integer square root, rounded down.
+     *
+     * @param n The value.
+     * @return floor(sqrt(n)).
+     */
+    constexpr uint16_t isqrt(uint32_t n) {
+        return static_cast<uint16_t>(isqrtStep(n, 0, 1UL << 30));
+    }
+}
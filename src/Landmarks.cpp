@@ -0,0 +1,116 @@
+/*
+ * File: Landmarks.cpp
+ *
+ * Description:
+ * This file implements the `Landmarks` namespace and holds the landmark
+ * table for the survey course. Positions are in the odometry frame: the
+ * origin is the start pose, x points forward and y follows the
+ * `FixedOdometry` sign convention.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include "Landmarks.h"
+
+#if LANDMARK_CORRECTION
+
+/*
+ * A known sign position on the course.
+ */
+struct Landmark {
+    int16_t x;       // x position (mm).
+    int16_t y;       // y position (mm).
+    uint8_t kind;    // IRSensor::PathSignType of the sign; None ends the table.
+};
+
+/*
+ * Landmark table, terminated by an entry of kind None.
+ * Add one line per surveyed sign, then set LANDMARK_CORRECTION, for example:
+ *     {1200, 0, IRSensor::CalculateElevation},
+ */
+static const Landmark landmarks[] PROGMEM = {
+        {0, 0, IRSensor::None},
+};
+
+static Landmarks::Residuals residuals = {0, 0, 0, 0};
+
+/*
+ * Records a detected sign and blends the pose toward the nearest matching landmark.
+ */
+bool Landmarks::observe(IRSensor::PathSignType kind, FixedOdometry &odometry) {
+    const int32_t x = odometry.getXQ8() >> 8;
+    const int32_t y = odometry.getYQ8() >> 8;
+
+    uint32_t bestDistance = 0xFFFFFFFF;
+    int16_t bestX = 0;
+    int16_t bestY = 0;
+
+    for (uint8_t i = 0;; i++) {
+        const uint8_t entryKind = pgm_read_byte(&landmarks[i].kind);
+        if (entryKind == IRSensor::None) {
+            break;
+        }
+        if (entryKind != kind) {
+            continue;
+        }
+
+        const int16_t landmarkX = pgm_read_word(&landmarks[i].x);
+        const int16_t landmarkY = pgm_read_word(&landmarks[i].y);
+        const int32_t dx = landmarkX - x;
+        const int32_t dy = landmarkY - y;
+        if (dx > LANDMARK_GATE_MM || dx < -LANDMARK_GATE_MM || dy > LANDMARK_GATE_MM || dy < -LANDMARK_GATE_MM) {
+            continue;
+        }
+
+        const uint32_t distance = dx * dx + dy * dy;
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            bestX = landmarkX;
+            bestY = landmarkY;
+        }
+    }
+
+    if (bestDistance > static_cast<uint32_t>(LANDMARK_GATE_MM) * LANDMARK_GATE_MM) {
+        residuals.rejected += 1;
+        return false;
+    }
+
+    const uint16_t residual = sqrt(bestDistance);
+    residuals.corrections += 1;
+    residuals.sum += residual;
+    if (residual > residuals.max) {
+        residuals.max = residual;
+    }
+
+    odometry.correct(static_cast<int32_t>(bestX) << 8, static_cast<int32_t>(bestY) << 8, LANDMARK_BLEND_SHIFT);
+    return true;
+}
+
+#else
+
+bool Landmarks::observe(IRSensor::PathSignType, FixedOdometry &) {
+    return false;
+}
+
+#endif
+
+/*
+ * Clears the residual statistics.
+ */
+void Landmarks::resetResiduals() {
+#if LANDMARK_CORRECTION
+    residuals = {0, 0, 0, 0};
+#endif
+}
+
+/*
+ * Returns the residual statistics since the last reset.
+ */
+Landmarks::Residuals Landmarks::getResiduals() {
+#if LANDMARK_CORRECTION
+    return residuals;
+#else
+    return {0, 0, 0, 0};
+#endif
+}
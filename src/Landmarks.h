@@ -0,0 +1,55 @@
+/*
+ * File: Landmarks.h
+ *
+ * Description:
+ * This header file declares the `Landmarks` namespace, which corrects
+ * odometry drift using the known positions of path signs on the course.
+ * When a sign is confidently detected, the nearest landmark of the same
+ * kind (within a gate) is looked up in a PROGMEM table and the pose is
+ * blended toward it. Residuals are recorded so the correction can be
+ * checked after the run.
+ *
+ * Compiled out unless LANDMARK_CORRECTION is set in RATS.h.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+#include "IRSensor.h"
+#include "FixedOdometry.h"
+
+namespace Landmarks {
+
+    /*
+     * Residual statistics of the corrections made during a run.
+     */
+    struct Residuals {
+        uint16_t corrections;    // Number of landmarks applied.
+        uint16_t rejected;       // Detections with no landmark inside the gate.
+        uint32_t sum;            // Sum of residual distances (mm).
+        uint16_t max;            // Largest residual distance (mm).
+    };
+
+    /*
+     * Records a detected sign and, if a landmark of that kind lies within
+     * LANDMARK_GATE_MM of the current pose, blends the pose toward it.
+     *
+     * kind: The sign that was detected.
+     * odometry: The odometry to correct.
+     * returns: True if the pose was corrected.
+     */
+    bool observe(IRSensor::PathSignType kind, FixedOdometry &odometry);
+
+    /*
+     * Clears the residual statistics.
+     */
+    void resetResiduals();
+
+    /*
+     * Returns the residual statistics since the last reset.
+     */
+    Residuals getResiduals();
+}
@@ -0,0 +1,257 @@
+/*
+ * File: LapLearning.cpp
+ *
+ * Description:
+ * This file implements the `LapLearning` namespace. One byte buffer holds
+ * the course: the curvature magnitude of each segment while learning (and
+ * in EEPROM), and the speed limit of each segment while replaying. The
+ * speed limits are computed in place, walking back from the end of the
+ * course: each segment is limited by its curvature (v² = a * r) and by
+ * braking down to the next segment's limit (v² = v_next² + 2 * a * ds).
+ *
+ * Each course slot in EEPROM is a `Header` followed by LAP_SEGMENTS bytes.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include <avr/eeprom.h>
+#include "LapLearning.h"
+#include "IntegerMath.h"
+#include "SpeedControl.h"
+
+namespace LapLearning {
+
+    /*
+     * Course slot header, as stored in EEPROM.
+     */
+    struct Header {
+        uint8_t magic;           // LAP_EEPROM_MAGIC + course when the slot holds a course.
+        uint8_t scale;           // Segments are 2^(LAP_SEGMENT_SHIFT + scale) mm long.
+        uint8_t count;           // Number of segments.
+        uint8_t checksum;        // Sum of the segment bytes.
+        uint32_t length;         // Learned course length (Q8 mm).
+        microseconds bestLap;    // Best replayed lap time (µs), 0 for none.
+    };
+
+    uint8_t course = 0;
+    Header header;
+    bool learning = true;
+    uint8_t samples[LAP_SEGMENTS];       // Curvature (learning) or speed limits (replaying) per segment.
+    int32_t segmentEnd = 0;              // End of the segment being recorded (Q8 mm).
+    FixedTrig::BinaryAngle segmentHeading = 0; // Heading at its start.
+
+    uint8_t *slotAddress();
+    uint8_t checksum();
+    void save();
+    void buildProfile();
+}
+
+/*
+ * Returns the EEPROM address of the current course's slot.
+ */
+uint8_t *LapLearning::slotAddress() {
+    return reinterpret_cast<uint8_t *>(LAP_EEPROM_ADDRESS + course * (sizeof(Header) + LAP_SEGMENTS));
+}
+
+/*
+ * Returns the checksum of the recorded segments.
+ */
+uint8_t LapLearning::checksum() {
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < header.count; i++) {
+        sum += samples[i];
+    }
+    return sum;
+}
+
+/*
+ * Writes the header and the recorded segments to the course's slot.
+ */
+void LapLearning::save() {
+    uint8_t *address = slotAddress();
+    eeprom_update_block(&header, address, sizeof(Header));
+    eeprom_update_block(samples, address + sizeof(Header), header.count);
+}
+
+/*
+ * Turns the recorded curvature into per-segment speed limits, in place.
+ */
+void LapLearning::buildProfile() {
+    const uint32_t segment = 1UL << (LAP_SEGMENT_SHIFT + header.scale);
+    const uint32_t topSpeed = SpeedControl::toMillimetresPerSecond(MAX_SPEED);
+    const uint32_t top = topSpeed * topSpeed;
+    const uint32_t lateral = static_cast<uint32_t>(LAP_LATERAL_ACCELERATION) * segment;
+    const uint32_t braking = 2UL * LAP_BRAKING_ACCELERATION * segment;
+
+    uint32_t next = top;
+    for (uint8_t i = header.count; i-- > 0;) {
+        // v² = a * ds / dθ, with dθ = curvature * 2^LAP_CURVATURE_SHIFT * 2π / 65536.
+        uint32_t limit = top;
+        if (samples[i] != 0 && lateral / samples[i] < top / (10430 >> LAP_CURVATURE_SHIFT)) {
+            limit = (lateral / samples[i]) * (10430 >> LAP_CURVATURE_SHIFT);
+        }
+        if (next + braking < limit) {
+            limit = next + braking;
+        }
+        next = limit;
+
+        const int16_t speed = TO_SPEED_UNITS(static_cast<int16_t>(IntegerMath::isqrt(limit)));
+        samples[i] = speed < LAP_MIN_SPEED ? LAP_MIN_SPEED : speed;
+    }
+}
+
+/**
+ * Prepares a run on a course: loads its learned profile if there is
+ * one, otherwise starts learning it.
+ *
+ * @param course The course (0 to LAP_COURSES - 1).
+ */
+void LapLearning::begin(uint8_t course) {
+    LapLearning::course = course;
+    uint8_t *address = slotAddress();
+    eeprom_read_block(&header, address, sizeof(Header));
+
+    learning = header.magic != LAP_EEPROM_MAGIC + course || header.count == 0 || header.count > LAP_SEGMENTS;
+    if (!learning) {
+        eeprom_read_block(samples, address + sizeof(Header), header.count);
+        learning = checksum() != header.checksum;
+    }
+
+    if (learning) {
+        header.magic = LAP_EEPROM_MAGIC + course;
+        header.scale = 0;
+        header.count = 0;
+        header.bestLap = 0;
+        segmentEnd = 1L << (LAP_SEGMENT_SHIFT + 8);
+        segmentHeading = 0;
+    } else {
+        buildProfile();
+    }
+}
+
+/**
+ * Checks if the current run is learning its course.
+ *
+ * @return True while recording, false while driving a learned profile.
+ */
+bool LapLearning::isLearning() {
+    return learning;
+}
+
+/**
+ * Records the path while learning. Call once per frame after the
+ * odometry update.
+ *
+ * @param distance Distance travelled (Q8 mm).
+ * @param heading Encoder heading (65536 per turn).
+ */
+void LapLearning::record(int32_t distance, FixedTrig::BinaryAngle heading) {
+    if (!learning) {
+        return;
+    }
+
+    while (distance >= segmentEnd) {
+        // The buffer is full: halve the resolution by merging neighbouring segments.
+        if (header.count == LAP_SEGMENTS) {
+            for (uint8_t i = 0; i < LAP_SEGMENTS / 2; i++) {
+                const uint16_t merged = samples[2 * i] + samples[2 * i + 1];
+                samples[i] = merged > 0xFF ? 0xFF : merged;
+            }
+            header.count = LAP_SEGMENTS / 2;
+            header.scale += 1;
+        }
+
+        // Only the magnitude matters for the speed limit; it is kept so
+        // merging an S-bend does not cancel it out.
+        const int16_t change = heading - segmentHeading;
+        const uint16_t curvature = (abs(static_cast<int32_t>(change)) + (1 << (LAP_CURVATURE_SHIFT - 1))) >> LAP_CURVATURE_SHIFT;
+        samples[header.count++] = curvature > 0xFF ? 0xFF : curvature;
+        segmentHeading = heading;
+        segmentEnd += 1L << (LAP_SEGMENT_SHIFT + 8 + header.scale);
+    }
+}
+
+/**
+ * Gets the learned speed limit at a point of the course.
+ *
+ * @param distance Distance travelled (Q8 mm).
+ * @return The speed limit (path-following units), MAX_SPEED while learning.
+ */
+int16_t LapLearning::speedAt(int32_t distance) {
+    if (learning) {
+        return MAX_SPEED;
+    }
+
+    // The slower of the current segment and the one LAP_LOOKAHEAD ahead.
+    const uint8_t shift = LAP_SEGMENT_SHIFT + 8 + header.scale;
+    int32_t here = distance > 0 ? distance >> shift : 0;
+    int32_t ahead = (distance + (static_cast<int32_t>(LAP_LOOKAHEAD) << 8)) >> shift;
+    here = here < header.count ? here : header.count - 1;
+    ahead = ahead < 0 ? 0 : ahead < header.count ? ahead : header.count - 1;
+    return samples[here] < samples[ahead] ? samples[here] : samples[ahead];
+}
+
+/**
+ * Ends the run: saves a learned course, or checks a replayed one
+ * against it and keeps the best lap time. A run that did not reach
+ * the end of the course changes nothing.
+ *
+ * @param lapTime Time of the run (µs).
+ * @param distance Distance travelled (Q8 mm).
+ * @param completed True if the run reached the end of the course.
+ * @return How the run ended.
+ */
+LapLearning::Outcome LapLearning::finish(microseconds lapTime, int32_t distance, bool completed) {
+    // A partial recording is not the course, and a partial replay is neither a lap nor a mismatch.
+    if (!completed) {
+        return Incomplete;
+    }
+
+    if (learning) {
+        header.length = distance > 0 ? distance : 0;
+        header.checksum = checksum();
+        save();
+        learning = false;
+        return Learned;
+    }
+
+    const int32_t error = distance - static_cast<int32_t>(header.length);
+    if (abs(error) > static_cast<int32_t>(header.length >> LAP_LENGTH_TOLERANCE_SHIFT)) {
+        eeprom_update_byte(slotAddress(), 0);
+        learning = true;
+        return Mismatch;
+    }
+
+    if (header.bestLap == 0 || lapTime < header.bestLap) {
+        header.bestLap = lapTime;
+        eeprom_update_block(&header, slotAddress(), sizeof(Header));
+    }
+    return Replayed;
+}
+
+/**
+ * Gets the best replayed lap time of the current course.
+ *
+ * @return The lap time (µs), 0 if none yet.
+ */
+microseconds LapLearning::getBestLap() {
+    return header.bestLap;
+}
+
+/*
+ * Returns a short name for an outcome, for logging.
+ */
+const char *LapLearning::describe(Outcome outcome) {
+    switch (outcome) {
+        case Learned:
+            return "learned";
+        case Replayed:
+            return "replayed";
+        case Mismatch:
+            return "mismatch";
+        case Incomplete:
+            return "incomplete";
+    }
+    return "?";
+}
@@ -0,0 +1,90 @@
+/*
+ * File: LapLearning.h
+ *
+ * Description:
+ * This header file declares the `LapLearning` namespace, which learns a
+ * course on its first run and drives later runs with a speed profile made
+ * for it. While learning, the curvature of the path (the encoder heading
+ * change per segment of distance travelled) is recorded into a compact
+ * buffer that is downsampled when the course outgrows it, and saved to the
+ * course's EEPROM slot once the run ends. Later runs on that course turn
+ * the curvature into a speed limit per segment that respects a lateral
+ * acceleration limit and brakes ahead of every slower segment.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+#include "FixedTrig.h"
+
+namespace LapLearning {
+
+    /*
+     * How a run ended.
+     */
+    typedef enum LO {
+        Learned,                 // The course was recorded and saved.
+        Replayed,                // The learned profile was driven.
+        Mismatch,                // The run did not match the learned course, which is forgotten.
+        Incomplete,              // The run was cut short; nothing was saved.
+    } Outcome;
+
+    /**
+     * Prepares a run on a course: loads its learned profile if there is
+     * one, otherwise starts learning it.
+     *
+     * @param course The course (0 to LAP_COURSES - 1).
+     */
+    void begin(uint8_t course);
+
+    /**
+     * Checks if the current run is learning its course.
+     *
+     * @return True while recording, false while driving a learned profile.
+     */
+    bool isLearning();
+
+    /**
+     * Records the path while learning. Call once per frame after the
+     * odometry update.
+     *
+     * @param distance Distance travelled (Q8 mm).
+     * @param heading Encoder heading (65536 per turn).
+     */
+    void record(int32_t distance, FixedTrig::BinaryAngle heading);
+
+    /**
+     * Gets the learned speed limit at a point of the course.
+     *
+     * @param distance Distance travelled (Q8 mm).
+     * @return The speed limit (path-following units), MAX_SPEED while learning.
+     */
+    int16_t speedAt(int32_t distance);
+
+    /**
+     * Ends the run: saves a learned course, or checks a replayed one
+     * against it and keeps the best lap time. A run that did not reach
+     * the end of the course changes nothing.
+     *
+     * @param lapTime Time of the run (µs).
+     * @param distance Distance travelled (Q8 mm).
+     * @param completed True if the run reached the end of the course.
+     * @return How the run ended.
+     */
+    Outcome finish(microseconds lapTime, int32_t distance, bool completed);
+
+    /**
+     * Gets the best replayed lap time of the current course.
+     *
+     * @return The lap time (µs), 0 if none yet.
+     */
+    microseconds getBestLap();
+
+    /**
+     * Returns a short name for an outcome, for logging.
+     */
+    const char *describe(Outcome outcome);
+}
@@ -0,0 +1,82 @@
+/*
+ * File: LineController.cpp
+ *
+ * Description:
+ * This file implements the `LineController` namespace and holds its gain
+ * table. The table is generated by `python3 research/lqr_design.py`, which
+ * also documents the model, its parameters and the LQR weights; run it
+ * with --sim to compare the step response against the PD law.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include "LineController.h"
+#include "GainSchedule.h"
+
+/*
+ * LQR gains every 2^GAIN_SCHEDULE_SHIFT mm/s, from 0.
+ * Generated by research/lqr_design.py; regenerate after changing the model.
+ */
+static const LineController::Gains gainTable[] PROGMEM = {
+        {   30,   328,   107,  -120}, //    0 mm/s
+        {   30,   249,    69,  -126}, //  256 mm/s
+        {   29,   190,    37,  -138}, //  512 mm/s
+        {   28,   166,    22,  -149}, //  768 mm/s
+        {   28,   153,    12,  -159}, // 1024 mm/s
+        {   27,   143,     3,  -168}, // 1280 mm/s
+        {   27,   136,    -4,  -177}, // 1536 mm/s
+        {   26,   130,   -10,  -185}, // 1792 mm/s
+        {   26,   125,   -15,  -192}, // 2048 mm/s
+};
+
+static_assert(sizeof(gainTable) / sizeof(gainTable[0]) == GAIN_SCHEDULE_POINTS,
+              "gainTable needs one row per GAIN_SCHEDULE_POINTS");
+
+namespace LineController {
+
+    int16_t lastOffset = 0;              // Offset at the previous update.
+    int16_t lastOutput = 0;              // Command of the previous update.
+    bool primed = false;                 // False until the first update after a reset.
+}
+
+/*
+ * Looks up the gains for a speed (mm/s).
+ */
+LineController::Gains LineController::lookup(int16_t speed) {
+    return GainSchedule::interpolateRow(gainTable, speed);
+}
+
+/*
+ * Forgets the previous offset and command.
+ */
+void LineController::reset() {
+    lastOffset = 0;
+    lastOutput = 0;
+    primed = false;
+}
+
+/*
+ * Runs one controller step.
+ */
+int16_t LineController::update(int16_t offset, int16_t left, int16_t right, microseconds dt, int16_t limit) {
+    // A long gap (or the first update) leaves no rate to measure.
+    int32_t change = 0;
+    if (primed && dt <= PID_MAX_DT) {
+        const int32_t period = dt >> PID_TIME_SHIFT ? dt >> PID_TIME_SHIFT : 1;
+        change = static_cast<int32_t>(offset - lastOffset) * (PID_NOMINAL_DT >> PID_TIME_SHIFT) / period;
+    } else {
+        lastOutput = 0;
+    }
+    lastOffset = offset;
+    primed = true;
+
+    const Gains gains = lookup((left + right) / 2);
+    const int32_t output = static_cast<int32_t>(gains.offset) * offset +
+                           static_cast<int32_t>(gains.change) * change +
+                           static_cast<int32_t>(gains.yawRate) * (left - right) +
+                           static_cast<int32_t>(gains.previous) * lastOutput;
+
+    lastOutput = constrain(output >> 8, -limit, limit);
+    return lastOutput;
+}
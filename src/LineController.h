@@ -0,0 +1,62 @@
+/*
+ * File: LineController.h
+ *
+ * Description:
+ * This header file declares the `LineController` namespace, a model-based
+ * alternative to the line-following PD law. It feeds back the lateral
+ * offset of the line, its rate of change, the measured yaw rate (as the
+ * wheel velocity difference) and the previous command, which stands in for
+ * the one-frame delay between reading the line and the wheels reacting.
+ * The gains are designed offline as a discrete LQR for a differential-drive
+ * model at each table speed (research/lqr_design.py), kept in a PROGMEM
+ * table every 2^GAIN_SCHEDULE_SHIFT mm/s and interpolated on the measured
+ * speed.
+ *
+ * Used by PathFollowing::follow() when LINE_CONTROLLER_LQR is set.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+
+namespace LineController {
+
+    /**
+     * State feedback gains, output (speed units) * 256 per unit of each input.
+     */
+    struct Gains {
+        int16_t offset;                  // Per line position unit.
+        int16_t change;                  // Per line position unit of change per nominal frame.
+        int16_t yawRate;                 // Per mm/s of left minus right wheel velocity.
+        int16_t previous;                // Per speed unit of the previous command.
+    };
+
+    /**
+     * Looks up the gains for a speed.
+     *
+     * @param speed Forward speed (mm/s); negative speeds use the gains for 0.
+     * @return The interpolated gains.
+     */
+    Gains lookup(int16_t speed);
+
+    /**
+     * Forgets the previous offset and command. Call whenever line following
+     * is interrupted.
+     */
+    void reset();
+
+    /**
+     * Runs one controller step.
+     *
+     * @param offset Line position - 2000.
+     * @param left Measured left wheel velocity (mm/s).
+     * @param right Measured right wheel velocity (mm/s).
+     * @param dt Time since the previous update (µs).
+     * @param limit Output limit (+/-).
+     * @return The speed difference (left faster when positive), in path-following speed units.
+     */
+    int16_t update(int16_t offset, int16_t left, int16_t right, microseconds dt, int16_t limit);
+}
@@ -0,0 +1,152 @@
+/*
+ * File: MotionProfile.h
+ *
+ * Description:
+ * This file defines the `MotionProfile` class, which shapes the forward
+ * speed of line following. Instead of jumping to a new speed, the profile
+ * ramps toward it with a bounded acceleration, and the acceleration itself
+ * changes at a bounded rate (jerk), easing in and out of every speed
+ * change. Below a launch speed a lower acceleration limit applies, since
+ * that is where the wheels slip most easily, and the caller can back the
+ * profile off when it sees the wheels slip.
+ *
+ * Speeds are in path-following units (see SpeedControl).
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+#include "IntegerMath.h"
+
+/**
+ * Class for jerk- and acceleration-limited speed transitions.
+ */
+class MotionProfile {
+private:
+    int32_t speed;                       // Profiled speed (units * 1024).
+    int32_t acceleration;                // Current acceleration (units/s²).
+    int16_t target;                      // Speed to reach (units).
+    const uint16_t maxAcceleration;      // Acceleration limit (units/s²).
+    const uint16_t maxJerk;              // Jerk limit (units/s³).
+    const uint16_t launchAcceleration;   // Acceleration limit below launchSpeed (units/s²).
+    const int16_t launchSpeed;           // Speed below which the launch limit applies (units).
+
+public:
+    /**
+     * Constructor to initialize a profile standing still.
+     *
+     * @param maxAcceleration Acceleration limit (units/s²).
+     * @param maxJerk Jerk limit (units/s³), at most 32767.
+     * @param launchAcceleration Acceleration limit below launchSpeed (units/s²).
+     * @param launchSpeed Speed below which the launch limit applies (units).
+     */
+    MotionProfile(uint16_t maxAcceleration, uint16_t maxJerk, uint16_t launchAcceleration, int16_t launchSpeed)
+            : speed(0), acceleration(0), target(0), maxAcceleration(maxAcceleration), maxJerk(maxJerk),
+              launchAcceleration(launchAcceleration), launchSpeed(launchSpeed) {}
+
+    /**
+     * Converts a time step to seconds * 2^20, the profile's time unit.
+     * Steps longer than PID_MAX_DT are cut to it.
+     *
+     * @param dt The time step (µs).
+     */
+    static uint32_t toSeconds(microseconds dt) {
+        if (dt > PID_MAX_DT) {
+            dt = PID_MAX_DT;
+        }
+        return (dt * 1073UL) >> 10;
+    }
+
+    /**
+     * Jumps to a speed, e.g. 0 once the robot has been stopped.
+     */
+    void reset(int16_t speed) {
+        this->speed = static_cast<int32_t>(speed) << 10;
+        acceleration = 0;
+    }
+
+    /**
+     * Sets the speed to ramp toward.
+     */
+    void setTarget(int16_t target) {
+        this->target = target;
+    }
+
+    /**
+     * Stops accelerating and drops the speed by `backoff`, to let
+     * slipping wheels grip again.
+     *
+     * @param backoff Speed to give up (units).
+     */
+    void backOff(int16_t backoff) {
+        acceleration = 0;
+        speed -= static_cast<int32_t>(backoff) << 10;
+        if (speed < 0) {
+            speed = 0;
+        }
+    }
+
+    /**
+     * Advances the profile by one time step.
+     *
+     * @param dt Time since the previous step (µs).
+     * @return The profiled speed (units).
+     */
+    int16_t step(microseconds dt) {
+        const uint32_t seconds = toSeconds(dt);
+        const int32_t goal = static_cast<int32_t>(target) << 10;
+        const int32_t error = goal - speed;
+        if (error == 0) {
+            acceleration = 0;
+            return target;
+        }
+
+        // The largest acceleration that the jerk limit can still bring back
+        // to zero by the time the target is reached.
+        const uint32_t distance = error > 0 ? error : -error;
+        const uint16_t limit = speed < (static_cast<int32_t>(launchSpeed) << 10) ? launchAcceleration : maxAcceleration;
+        uint16_t reachable = IntegerMath::isqrt((2UL * maxJerk * (distance >> 5)) >> 5);
+        if (reachable > limit) {
+            reachable = limit;
+        }
+        const int32_t desired = error > 0 ? reachable : -static_cast<int32_t>(reachable);
+
+        int32_t jerkStep = (static_cast<int32_t>(maxJerk) * seconds) >> 20;
+        if (jerkStep < 1) {
+            jerkStep = 1;
+        }
+        if (acceleration < desired) {
+            acceleration = acceleration + jerkStep < desired ? acceleration + jerkStep : desired;
+        } else {
+            acceleration = acceleration - jerkStep > desired ? acceleration - jerkStep : desired;
+        }
+
+        speed += (acceleration * static_cast<int32_t>(seconds)) >> 10;
+        if (reachable == 0 || (error > 0 && speed >= goal) || (error < 0 && speed <= goal)) {
+            speed = goal;
+            acceleration = 0;
+        }
+        return speed >> 10;
+    }
+
+    /**
+     * Gets the profiled speed.
+     *
+     * @return The speed (units).
+     */
+    int16_t getSpeed() const {
+        return speed >> 10;
+    }
+
+    /**
+     * Gets the current acceleration.
+     *
+     * @return The acceleration (units/s²).
+     */
+    int32_t getAcceleration() const {
+        return acceleration;
+    }
+};
@@ -6,7 +6,17 @@
  * functionality for robot line-following behavior. It includes methods
  * for starting and stopping the path-following process, turning the robot,
  * and managing speed adjustments. The PID algorithm is used for precise
- * line-following navigation.
+ * line-following navigation, with its gains scheduled on the measured
+ * speed (see `GainSchedule`); its output is a pair of wheel velocities
+ * handed to the inner `SpeedControl` loop. The forward speed follows a
+ * jerk-limited `MotionProfile` toward maxSpeed and backs off when the
+ * wheels slip: when they gain speed the accelerometer does not see
+ * (forward slip, e.g. spinning up together on launch), or when the
+ * encoder and gyro yaw disagree (see `HeadingFilter`). Turns and holds
+ * are motion
+ * state machines advanced once per frame by step(); turns spin in place
+ * to a target angle on the fused gyro/encoder heading (see
+ * `TurnController`), and each motion fires an event when it finishes.
  *
  * Author: OCdt Syed
  * Version: 2024-12-01
@@ -14,6 +24,13 @@
 
 #include "PathFollowing.h"
 #include "IRSensor.h"
+#include "SpeedControl.h"
+#include "TurnController.h"
+#include "PidController.h"
+#include "GainSchedule.h"
+#include "LineController.h"
+#include "MotionProfile.h"
+#include "Clock.h"
 
 /**
  * Namespace for path-following functionality, including state management,
@@ -32,8 +49,42 @@ namespace PathFollowing {
     PathFollowerStates state = Ready;
 
     int maxSpeed = MAX_SPEED;
+    int speedLimit = MAX_SPEED;          // Cap from limitSpeed().
     int leftSpeed = 0;
     int rightSpeed = 0;
+
+    typedef enum MS {
+
+        Idle,
+        Spinning,
+        SeekingLine,
+        Holding,
+
+    } MotionState;
+
+    MotionState motion = Idle;
+    Event motionDone = NUMBER_OF_EVENTS;
+    microseconds motionStart = 0;
+    microseconds holdTime = 0;
+    TurnController turn;
+    FixedTrig::BinaryAngle heading = 0;
+
+    PidController linePid(PROPORTIONAL_CONSTANT, INTEGRAL_CONSTANT, DERIVATIVE_CONSTANT,
+                          DERIVATIVE_FILTER_TIME, MAX_SPEED);
+    microseconds lastFollow = 0;         // Time of the previous PID update.
+
+    MotionProfile profile(TO_SPEED_UNITS(PROFILE_ACCELERATION), TO_SPEED_UNITS(PROFILE_JERK),
+                          TO_SPEED_UNITS(PROFILE_LAUNCH_ACCELERATION), TO_SPEED_UNITS(PROFILE_LAUNCH_SPEED));
+    uint16_t headingSlips = 0;           // Heading filter slip count at the previous report.
+    uint16_t slips = 0;                  // Forward slips seen while following.
+    uint16_t yawSlips = 0;               // Heading filter slips seen while following.
+    int16_t lastWheelSpeed = 0;          // Mean measured wheel speed at the previous report (mm/s).
+    microseconds lastAcceleration = 0;   // Time of the previous acceleration report.
+    int32_t slipSpeed = 0;               // Wheel speed gained beyond the body's, leaking (mm/s).
+
+    void resetController();
+    void beginMotion(MotionState next, Event done);
+    void beginTurn(int32_t angle, bool seekLine, Event done);
 }
 
 /**
@@ -51,14 +102,18 @@ bool PathFollowing::canFollowPath() {
     */
 void PathFollowing::start() {
     state = Following;
+    resetController();
 }
 
 /**
  * Stops the robot and sets the state to `ReachedEnd`.
  */
 void PathFollowing::stop() {
+    SpeedControl::disable();
     Pololu3piPlus32U4::Motors::setSpeeds(0, 0);
     state = ReachedEnd;
+    resetController();
+    profile.reset(0);
 }
 
 /**
@@ -80,57 +135,223 @@ int PathFollowing::getRightSpeed() {
 }
 
 /**
- * Turns the robot to the left.
+ * Gets the number of forward slips seen while following the line.
+ *
+ * @return The slip count since resetSlips().
  */
-void PathFollowing::turnLeft() {
-    Pololu3piPlus32U4::Motors::setSpeeds(0, 0);
-    delay(20);
-    Pololu3piPlus32U4::Motors::setSpeeds(-MAX_SPEED, MAX_SPEED);
-    delay(110);
-    Pololu3piPlus32U4::Motors::setSpeeds(0, 0);
-    delay(20);
-    Pololu3piPlus32U4::Motors::setSpeeds(MAX_SPEED - 50, MAX_SPEED);
-    milliseconds startTime = millis();
-    while (millis() - startTime < 300) {
-        while (millis() - startTime < 150) {}
-        if (IRSensor::detectLine().exists() && IRSensor::detectLine().get() > 2000) {
-            break;
-        }
+uint16_t PathFollowing::getSlips() {
+    return slips;
+}
+
+/**
+ * Gets the number of yaw slips (encoder and gyro yaw disagreeing) seen
+ * while following the line.
+ *
+ * @return The slip count since resetSlips().
+ */
+uint16_t PathFollowing::getYawSlips() {
+    return yawSlips;
+}
+
+/**
+ * Clears the slip counts, e.g. at the start of a run. Call after
+ * resetting the odometry, whose heading filter counts from 0 again.
+ */
+void PathFollowing::resetSlips() {
+    headingSlips = 0;
+    slips = 0;
+    yawSlips = 0;
+    slipSpeed = 0;
+}
+
+/**
+ * Takes the body's forward acceleration once per frame and compares it
+ * with the speed the wheels gained since the previous frame. Slip on
+ * both wheels at once leaves the yaw alone, so only this comparison
+ * sees it: the wheels spin up faster than the robot does. The
+ * difference is integrated with a leak, which averages out the
+ * accelerometer and wheel speed noise of single frames; past
+ * FORWARD_SLIP_THRESHOLD it counts as a slip and gives up some speed.
+ *
+ * @param acceleration Forward acceleration of the body (mm/s²).
+ */
+void PathFollowing::reportAcceleration(int16_t acceleration) {
+    const microseconds now = Clock::now();
+    const microseconds dt = now - lastAcceleration;
+    const int16_t wheelSpeed = (SpeedControl::getMeasuredLeft() + SpeedControl::getMeasuredRight()) / 2;
+    const int16_t wheelGain = wheelSpeed - lastWheelSpeed;
+    lastAcceleration = now;
+    lastWheelSpeed = wheelSpeed;
+
+    // One sample can't stand for a long gap; start over after one, or outside line following.
+    if (state != Following || motion != Idle || dt > HEADING_MAX_DT_US) {
+        slipSpeed = 0;
+        return;
     }
+
+    const int32_t bodyGain = static_cast<int32_t>(acceleration) * static_cast<int32_t>(dt) / 1000000L;
+    slipSpeed += wheelGain - bodyGain;
+    slipSpeed -= slipSpeed >> FORWARD_SLIP_LEAK_SHIFT;
+    if (slipSpeed <= FORWARD_SLIP_THRESHOLD) {
+        return;
+    }
+
+    slipSpeed = 0;
+    slips += 1;
+#if MOTION_PROFILE
+    profile.backOff(TO_SPEED_UNITS(SLIP_BACKOFF));
+#endif
 }
 
 /**
- * Turns the robot to the right.
+ * Takes the heading filter's slip count after each odometry update.
+ * The filter counts an update as slip when the encoder yaw and the gyro
+ * yaw disagree; unlike a wheel's own acceleration, that mismatch does not
+ * show up when the controller merely steps the wheel speeds apart. New
+ * slips while following give up some speed so the wheels grip again.
+ *
+ * @param count The heading filter's slip count.
  */
-void PathFollowing::turnRight() {
-    Pololu3piPlus32U4::Motors::setSpeeds(0, 0);
-    delay(20);
-    Pololu3piPlus32U4::Motors::setSpeeds(MAX_SPEED, -MAX_SPEED);
-    delay(110);
-    Pololu3piPlus32U4::Motors::setSpeeds(0, 0);
-    delay(20);
-    Pololu3piPlus32U4::Motors::setSpeeds(MAX_SPEED, MAX_SPEED - 50);
-    milliseconds startTime = millis();
-    while (millis() - startTime < 300) {
-        while (millis() - startTime < 150) {}
-        if (IRSensor::detectLine().exists() && IRSensor::detectLine().get() > 2000) {
-            break;
-        }
+void PathFollowing::reportHeadingSlips(uint16_t count) {
+    const uint16_t fresh = count - headingSlips;
+    headingSlips = count;
+    if (fresh == 0 || state != Following || motion != Idle) {
+        return;
     }
+
+    yawSlips += fresh;
+#if MOTION_PROFILE
+    profile.backOff(TO_SPEED_UNITS(SLIP_BACKOFF));
+#endif
+}
+
+/**
+ * Clears the line controller's history, so nothing carries over a stop,
+ * turn or hold.
+ */
+void PathFollowing::resetController() {
+#if LINE_CONTROLLER_LQR
+    LineController::reset();
+#else
+    linePid.reset();
+#endif
+}
+
+/**
+ * Stops the motors and starts a motion that ends by firing `done`.
+ */
+void PathFollowing::beginMotion(MotionState next, Event done) {
+    SpeedControl::disable();
+    Pololu3piPlus32U4::Motors::setSpeeds(0, 0);
+    motion = next;
+    motionDone = done;
+    motionStart = Clock::now();
+    resetController();
+    profile.reset(0);
+}
+
+/**
+ * Starts spinning in place by `angle` on the fused heading, decelerating
+ * toward the target. With `seekLine`, the turn ends early once the line is
+ * centered under the sensors within the last TURN_LINE_WINDOW of the turn.
+ */
+void PathFollowing::beginTurn(int32_t angle, bool seekLine, Event done) {
+    beginMotion(seekLine ? SeekingLine : Spinning, done);
+    turn.begin(heading, angle);
+}
+
+/**
+ * Turns the robot 90 degrees to the left.
+ *
+ * @param done Event fired when the turn finishes, NUMBER_OF_EVENTS for none.
+ */
+void PathFollowing::turnLeft(Event done) {
+    beginTurn(TURN_ANGLE_90, true, done);
+}
+
+/**
+ * Turns the robot 90 degrees to the right.
+ *
+ * @param done Event fired when the turn finishes, NUMBER_OF_EVENTS for none.
+ */
+void PathFollowing::turnRight(Event done) {
+    beginTurn(-TURN_ANGLE_90, true, done);
 }
 
 /**
  * Turns the robot 180 degrees to reverse its direction.
+ *
+ * @param done Event fired when the turn finishes, NUMBER_OF_EVENTS for none.
+ */
+void PathFollowing::turnAround(Event done) {
+    beginTurn(-TURN_ANGLE_180, false, done);
+}
+
+/**
+ * Stops the robot and keeps it still for a while, e.g. to take a measurement.
+ *
+ * @param duration Time to stand still (ms).
+ * @param done Event fired when the time is up, NUMBER_OF_EVENTS for none.
+ */
+void PathFollowing::hold(milliseconds duration, Event done) {
+    beginMotion(Holding, done);
+    holdTime = duration * 1000UL;
+}
+
+/**
+ * Checks if a turn or hold is in progress.
+ *
+ * @return True while a motion is running.
+ */
+bool PathFollowing::isBusy() {
+    return motion != Idle;
+}
+
+/**
+ * Advances the current motion by one frame. Call once per frame, after
+ * the sensors and the odometry have been updated.
+ *
+ * @param currentHeading Current fused heading (65536 per turn).
+ * @return The motion's completion event on the frame it finishes,
+ *         if it has one.
  */
-void PathFollowing::turnAround() {
-    Pololu3piPlus32U4::Motors::setSpeeds(-50, -50);
-    delay(2);
-    Pololu3piPlus32U4::Motors::setSpeeds(MAX_SPEED, -MAX_SPEED);
-    delay(190);
-    Pololu3piPlus32U4::Motors::setSpeeds(-50, -50);
-    delay(100);
-    IRSensor::resetPathSignDetector();
+Option<Event> PathFollowing::step(FixedTrig::BinaryAngle currentHeading) {
+    heading = currentHeading;
+
+    switch (motion) {
+        case Idle:
+            return Option<Event>();
+
+        case Spinning:
+        case SeekingLine: {
+            const int16_t speed = turn.step(heading);
+            if (motion == SeekingLine && !turn.isDone() && turn.inLineWindow()) {
+                LineDetectionResult line = IRSensor::detectLine();
+                if (line.exists() && abs(line.get() - 2000) < TURN_LINE_TOLERANCE) {
+                    turn.finish();
+                }
+            }
+            if (!turn.isDone() && Clock::now() - motionStart < TURN_TIMEOUT * 1000UL) {
+                SpeedControl::setTargets(-speed, speed);
+                return Option<Event>();
+            }
+            if (motion == Spinning) {
+                IRSensor::resetPathSignDetector();
+            }
+            break;
+        }
+
+        case Holding:
+            if (Clock::now() - motionStart < holdTime) {
+                return Option<Event>();
+            }
+            break;
+    }
+
+    SpeedControl::disable();
     Pololu3piPlus32U4::Motors::setSpeeds(0, 0);
+    motion = Idle;
+    return motionDone == NUMBER_OF_EVENTS ? Option<Event>() : Option<Event>(motionDone);
 }
 
 /**
@@ -142,6 +363,16 @@ void PathFollowing::slowToSpeed(int speed) {
     maxSpeed = speed;
 }
 
+/**
+ * Caps the speed independently of maxSpeed, e.g. with a learned speed
+ * profile; the lower of the two is driven.
+ *
+ * @param speed The speed limit, MAX_SPEED for none.
+ */
+void PathFollowing::limitSpeed(int speed) {
+    speedLimit = speed;
+}
+
 /**
   * Restores the robot's maximum speed to its default value.
   */
@@ -167,11 +398,7 @@ void PathFollowing::slowDown() {
  *
  */
 void PathFollowing::follow() {
-
-    static int lastError = 0;
-
-
-    if (state != Following) {
+    if (state != Following || motion != Idle) {
         return;
     }
 
@@ -186,26 +413,48 @@ void PathFollowing::follow() {
     /**
      * Our "error" is how far we are away from the center of the
      * line, which corresponds to position 2000.
+     *
+     * Get motor speed difference from the PID controller, scaled by the
+     * measured frame time (the integral term is generally not very
+     * useful for line following, so INTEGRAL_CONSTANT is 0).
     */
 
-    const int error = position - 2000;
+    const microseconds now = Clock::now();
+    const microseconds dt = now - lastFollow;
+    const int16_t measuredLeft = SpeedControl::getMeasuredLeft();
+    const int16_t measuredRight = SpeedControl::getMeasuredRight();
 
-    /** 
-     * Get motor speed difference using PROPORTIONAL_CONSTANT and derivative
-     * PID terms (the integral term is generally not very useful
-     * for line following). 
-    */
-
-    const int speedDifference = error * PROPORTIONAL_CONSTANT / 256 + (error - lastError) * DERIVATIVE_CONSTANT / 256;
-    lastError = error;
+    /**
+     * The forward speed ramps toward maxSpeed (or the lower speed
+     * limit) instead of jumping to it, so launches and speed changes
+     * stay within the traction limits.
+     */
+    const int16_t targetSpeed = speedLimit < maxSpeed ? speedLimit : maxSpeed;
+#if MOTION_PROFILE
+    profile.setTarget(targetSpeed);
+    const int16_t baseSpeed = profile.step(dt);
+#else
+    const int16_t baseSpeed = targetSpeed;
+#endif
+
+#if LINE_CONTROLLER_LQR
+    const int speedDifference = LineController::update(position - 2000, measuredLeft, measuredRight,
+                                                       dt, baseSpeed);
+#else
+    const GainSchedule::Gains gains = GainSchedule::lookup((measuredLeft + measuredRight) / 2);
+    linePid.setGains(gains.kp, gains.ki, gains.kd);
+    linePid.setLimit(baseSpeed);
+    const int speedDifference = linePid.update(2000, position, dt);
+#endif
+    lastFollow = now;
 
     /** 
      * Get individual motor speeds.  The sign of speedDifference
      * determines if the robot turns left or right.
     */
 
-    int leftSpeed = maxSpeed + speedDifference;
-    int rightSpeed = maxSpeed - speedDifference;
+    int leftSpeed = baseSpeed + speedDifference;
+    int rightSpeed = baseSpeed - speedDifference;
 
     /**
      * Constrain our motor speeds to be between 0 and MAX_SPEED.
@@ -216,12 +465,13 @@ void PathFollowing::follow() {
      * it can spin in reverse.
     */
 
-    leftSpeed = constrain(leftSpeed, MIN_SPEED, (int16_t) maxSpeed);
-    rightSpeed = constrain(rightSpeed, MIN_SPEED, (int16_t) maxSpeed);
+    leftSpeed = constrain(leftSpeed, MIN_SPEED, baseSpeed);
+    rightSpeed = constrain(rightSpeed, MIN_SPEED, baseSpeed);
 
     PathFollowing::leftSpeed = leftSpeed;
     PathFollowing::rightSpeed = rightSpeed;
 
-    // Zoom
-    Pololu3piPlus32U4::Motors::setSpeeds(leftSpeed, rightSpeed);
+    // Zoom (the inner loop holds these wheel velocities regardless of battery)
+    SpeedControl::setTargets(SpeedControl::toMillimetresPerSecond(leftSpeed),
+                             SpeedControl::toMillimetresPerSecond(rightSpeed));
 }
\ No newline at end of file
@@ -14,9 +14,12 @@
 #pragma once
 
 #include "RATS.h"
+#include "FixedTrig.h"
+#include "EventManager.h"
 
 namespace PathFollowing {
 
+
     /**
      * Starts the path-following process.
      * Sets the robot's state to `Following`.
@@ -40,6 +43,14 @@ namespace PathFollowing {
      */
     void slowToSpeed(int speed);
 
+    /**
+     * Caps the speed independently of maxSpeed, e.g. with a learned speed
+     * profile; the lower of the two is driven.
+     *
+     * @param speed The speed limit, MAX_SPEED for none.
+     */
+    void limitSpeed(int speed);
+
     /**
      * Restores the robot's maximum speed to its default value.
      */
@@ -59,19 +70,54 @@ namespace PathFollowing {
     void follow();
 
     /**
-     * Turns the robot to the left.
+     * Starts turning the robot 90 degrees to the left, ending early once
+     * the line is re-acquired near the target angle. Path following is
+     * paused until the turn finishes.
+     *
+     * @param done Event fired when the turn finishes (none by default).
+     */
+    void turnLeft(Event done = NUMBER_OF_EVENTS);
+
+    /**
+     * Starts turning the robot 90 degrees to the right, ending early once
+     * the line is re-acquired near the target angle.
+     *
+     * @param done Event fired when the turn finishes (none by default).
+     */
+    void turnRight(Event done = NUMBER_OF_EVENTS);
+
+    /**
+     * Starts turning the robot 180 degrees to reverse its direction.
+     *
+     * @param done Event fired when the turn finishes (none by default).
+     */
+    void turnAround(Event done = NUMBER_OF_EVENTS);
+
+    /**
+     * Stops the robot and keeps it still for a while, e.g. to take a
+     * measurement.
+     *
+     * @param duration Time to stand still (ms).
+     * @param done Event fired when the time is up (none by default).
      */
-    void turnLeft();
+    void hold(milliseconds duration, Event done = NUMBER_OF_EVENTS);
 
     /**
-     * Turns the robot to the right.
+     * Checks if a turn or hold is in progress.
+     *
+     * @return True while a motion is running.
      */
-    void turnRight();
+    bool isBusy();
 
     /**
-     * Turns the robot 180 degrees to reverse its direction.
+     * Advances the current motion by one frame. Call once per frame,
+     * after the sensors and the odometry have been updated.
+     *
+     * @param heading Current fused heading (65536 per turn).
+     * @return The motion's completion event on the frame it finishes,
+     *         if it has one.
      */
-    void turnAround();
+    Option<Event> step(FixedTrig::BinaryAngle heading);
 
     /**
      * Retrieves the current speed of the left motor.
@@ -86,4 +132,42 @@ namespace PathFollowing {
      * @return The speed of the right motor.
      */
     int getRightSpeed();
+
+    /**
+     * Gets the number of forward slips seen while following the line.
+     *
+     * @return The slip count since resetSlips().
+     */
+    uint16_t getSlips();
+
+    /**
+     * Gets the number of yaw slips (encoder and gyro yaw disagreeing)
+     * seen while following the line.
+     *
+     * @return The slip count since resetSlips().
+     */
+    uint16_t getYawSlips();
+
+    /**
+     * Clears the slip counts, e.g. at the start of a run.
+     */
+    void resetSlips();
+
+    /**
+     * Takes the body's forward acceleration once per frame; wheels
+     * gaining speed the body does not are forward slip, which backs the
+     * speed profile off.
+     *
+     * @param acceleration Forward acceleration from the accelerometer (mm/s²).
+     */
+    void reportAcceleration(int16_t acceleration);
+
+    /**
+     * Takes the heading filter's slip count (encoder and gyro yaw
+     * disagreeing) after each odometry update; new slips while following
+     * back the speed profile off.
+     *
+     * @param count The heading filter's slip count.
+     */
+    void reportHeadingSlips(uint16_t count);
 }
@@ -0,0 +1,142 @@
+/*
+ * File: PidController.h
+ *
+ * Description:
+ * This file defines the `PidController` class, a fixed-point PID controller
+ * that measures the time between updates instead of assuming a fixed frame.
+ * The derivative acts on the measurement rather than the error, so a
+ * setpoint change does not kick the output, and it is low-pass filtered.
+ * The optional integral only accumulates while the output is not saturated
+ * in the direction of the error (as in `SpeedControl`), and is clamped to
+ * the output limit.
+ *
+ * Gains keep their per-frame meaning: the I and D gains are scaled by
+ * dt / PID_NOMINAL_DT, so a controller tuned at the nominal frame rate
+ * behaves the same when frames stretch or shrink. Call reset() whenever the
+ * controlled motion is interrupted (stops, turns, holds); the first update
+ * after it only primes the derivative.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+
+/**
+ * Class for a dt-aware PID controller with a filtered derivative.
+ */
+class PidController {
+private:
+    int16_t kp;                          // Proportional gain * 256.
+    int16_t ki;                          // Integral gain per nominal period * 256.
+    int16_t kd;                          // Derivative gain per nominal period * 256.
+    uint16_t filterTime;                 // Derivative filter time constant (µs >> PID_TIME_SHIFT).
+    int16_t limit;                       // Output limit (+/-).
+
+    int32_t integral;                    // Integral term (output * 256).
+    int32_t derivative;                  // Filtered measurement change per nominal period * 16.
+    int16_t lastMeasurement;             // Measurement at the previous update.
+    bool primed;                         // False until the first update after a reset.
+
+public:
+    /**
+     * Constructor for the PidController.
+     *
+     * @param kp Proportional gain * 256.
+     * @param ki Integral gain per nominal period * 256, 0 for none.
+     * @param kd Derivative gain per nominal period * 256.
+     * @param filterTime Derivative filter time constant (µs), 0 for none.
+     * @param limit Output limit; the output stays within +/-limit.
+     */
+    PidController(int16_t kp, int16_t ki, int16_t kd, microseconds filterTime, int16_t limit)
+            : kp(kp), ki(ki), kd(kd), filterTime(filterTime >> PID_TIME_SHIFT), limit(limit) {
+        reset();
+    }
+
+    /**
+     * Forgets the integral and the derivative history.
+     */
+    void reset() {
+        integral = 0;
+        derivative = 0;
+        lastMeasurement = 0;
+        primed = false;
+    }
+
+    /**
+     * Changes the gains, keeping the controller's state.
+     */
+    void setGains(int16_t kp, int16_t ki, int16_t kd) {
+        this->kp = kp;
+        this->ki = ki;
+        this->kd = kd;
+    }
+
+    /**
+     * Changes the output limit.
+     */
+    void setLimit(int16_t limit) {
+        this->limit = limit;
+    }
+
+    /**
+     * Runs one controller step.
+     *
+     * @param setpoint The target value.
+     * @param measurement The measured value.
+     * @param dt Time since the previous update (µs).
+     * @return The output, positive when the measurement is above the setpoint.
+     */
+    int16_t update(int16_t setpoint, int16_t measurement, microseconds dt) {
+        const int16_t error = measurement - setpoint;
+        const int32_t proportional = (static_cast<int32_t>(error) * kp) >> 8;
+
+        // A long gap (or the first update) leaves nothing to differentiate or integrate over.
+        if (!primed || dt > PID_MAX_DT) {
+            derivative = 0;
+            lastMeasurement = measurement;
+            primed = true;
+            return constrain(proportional + (integral >> 8), -limit, limit);
+        }
+
+        const int32_t period = dt >> PID_TIME_SHIFT ? dt >> PID_TIME_SHIFT : 1;
+        const int32_t nominal = PID_NOMINAL_DT >> PID_TIME_SHIFT;
+
+        // Low-pass filtered rate, rearranged so one division does both the
+        // dt scaling and the filter: d += dt / (tau + dt) * (change / dt - d).
+        const int32_t change = static_cast<int32_t>(measurement - lastMeasurement) << 4;
+        lastMeasurement = measurement;
+        derivative = (derivative * filterTime + change * nominal) / (filterTime + period);
+        derivative = constrain(derivative, -(1L << 20), 1L << 20);
+
+        const int32_t output = proportional + (integral >> 8) + ((derivative * kd) >> 12);
+
+        // Anti-windup: only integrate when not saturated in the direction of the error.
+        if (ki != 0 && !(output >= limit && error > 0) && !(output <= -limit && error < 0)) {
+            integral += static_cast<int32_t>(error) * ki * period / nominal;
+            integral = constrain(integral, -(static_cast<int32_t>(limit) << 8), static_cast<int32_t>(limit) << 8);
+        }
+
+        return constrain(output, -limit, limit);
+    }
+
+    /**
+     * Gets the integral term.
+     *
+     * @return The integral contribution to the output * 256.
+     */
+    int32_t getIntegral() const {
+        return integral;
+    }
+
+    /**
+     * Gets the filtered derivative.
+     *
+     * @return The measurement change per nominal period * 16.
+     */
+    int32_t getDerivative() const {
+        return derivative;
+    }
+};
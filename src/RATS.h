@@ -34,7 +34,34 @@
  * Note: Adapted from Pololu3piplus documentation.
  */
 #define PROPORTIONAL_CONSTANT 64 // coefficient of the P term * 256
-#define DERIVATIVE_CONSTANT 256  // coefficient of the D term * 256
+#define INTEGRAL_CONSTANT 0      // coefficient of the I term per nominal frame * 256
+#define DERIVATIVE_CONSTANT 256  // coefficient of the D term per nominal frame * 256
+
+// Time constant of the derivative low-pass filter (µs, at most 32000). Half a frame:
+// a 32 Hz corner, well above the line loop, that still halves the frame-to-frame
+// jitter of the line position, at the cost of half a frame of lag.
+#define DERIVATIVE_FILTER_TIME 5000
+
+// Frame length the I and D gains are tuned for (µs).
+#define PID_NOMINAL_DT (MILLISECONDS_PER_FRAME * 1000L)
+
+// Gaps between PID updates longer than this (µs) restart the derivative and integral.
+#define PID_MAX_DT 50000
+
+// PID time unit: dt is handled in units of 2^PID_TIME_SHIFT µs to keep products in 32 bits.
+#define PID_TIME_SHIFT 4
+
+// Speed the PID constants above were tuned at (mm/s): SLOW_MAX_SPEED, the low speed
+// they perform well at. The gains are scheduled down above it.
+#define GAIN_REFERENCE_SPEED (SLOW_MAX_SPEED * SPEED_UNIT_MM_PER_S_X2 / 2)
+
+// 1 follows the line with the LQR state feedback of LineController (gains from
+// research/lqr_design.py), 0 with the scheduled PID.
+#define LINE_CONTROLLER_LQR 0
+
+// Gain schedule table: one entry every 2^GAIN_SCHEDULE_SHIFT mm/s from 0 (covers 0 - 2048 mm/s).
+#define GAIN_SCHEDULE_SHIFT 8
+#define GAIN_SCHEDULE_POINTS 9
 
 /**
  * 
@@ -43,7 +70,7 @@
  */
 #define MAG_THRESHOLD 15000 //TODO: Measure and adjust
 
-#define MAG_DEBOUNCE_THRESHOLD 1000
+#define MAG_DEBOUNCE_THRESHOLD 1000000UL // µs between logged anomalies
 
 /**
  * 
@@ -54,6 +81,214 @@
 #define TICKS_PER_REV  12.0      // Adjust based on your encoder
 #define WHEEL_DIAMETER 32.0     // mm
 
+// Encoder timer ticks (0.5 us) without an edge before a wheel counts as stopped.
+#define ENCODER_STOP_TIMEOUT 200000UL // 100 ms
+
+/**
+ *
+ * Heading Fusion Constants
+ *
+ */
+
+// Stationary gyro samples averaged for the offset during calibration.
+#define GYRO_CALIBRATION_SAMPLES 64
+
+// Gyro at +/- 2000 dps: 0.07 dps per digit, as 2^32-per-turn units per digit-µs * 2^24.
+#define GYRO_TURN_PER_DIGIT_US_Q24 14011199LL
+
+// Accelerometer at +/- 2 g: 0.061 mg per digit, as mm/s² per digit * 2^10.
+#define ACCEL_MM_S2_PER_DIGIT_Q10 612
+
+// Encoder/gyro disagreement (2^32 per turn) in one update treated as wheel slip.
+#define HEADING_SLIP_THRESHOLD 11930465L // 1 degree
+
+// Pull toward the encoder heading by 1 / 2^HEADING_BLEND_SHIFT per update.
+#define HEADING_BLEND_SHIFT 8
+
+// Bias estimate moves by 1 / 2^HEADING_BIAS_SHIFT per zero-velocity update.
+#define HEADING_BIAS_SHIFT 5
+
+// Updates with neither wheel ticking before the robot counts as standing still.
+#define HEADING_STILL_UPDATES 10
+
+// Longest gap (µs) one gyro sample may be integrated over.
+#define HEADING_MAX_DT_US 30000UL
+
+/**
+ *
+ * Landmark Correction Constants
+ *
+ */
+
+// 1 blends the pose toward surveyed sign positions (see Landmarks.cpp), 0 compiles it out.
+// Off until the sign positions are measured: the landmark table is still empty.
+#define LANDMARK_CORRECTION 0
+
+// Largest distance (mm) between the pose and a landmark that is still trusted.
+#define LANDMARK_GATE_MM 200
+
+// Pose moves 1 / 2^LANDMARK_BLEND_SHIFT of the way to a landmark (0 snaps).
+#define LANDMARK_BLEND_SHIFT 1
+
+/**
+ *
+ * Wheel Speed Control Constants
+ *
+ */
+
+// Control period in encoder timer ticks (0.5 us).
+#define SPEED_CONTROL_PERIOD 10000 // 5 ms, 200 Hz
+
+// One path-following speed unit in mm/s * 2 (MAX_SPEED 200 ~ 1.5 m/s).
+#define SPEED_UNIT_MM_PER_S_X2 15
+
+// Battery voltage the feedforward gain was measured at.
+#define BATTERY_NOMINAL_MV 4800
+
+// Below this battery voltage, wheel speed targets are scaled down.
+#define BATTERY_DERATE_MV 4200
+
+// Open-loop PWM needed per m/s of wheel speed at BATTERY_NOMINAL_MV, before the
+// deadband. A motor command of 200 drives about 1.5 m/s (MAX_SPEED); less the
+// deadband that is 187 PWM of effective drive (see SpeedControl.cpp), 187 / 1.5.
+#define FEEDFORWARD_PWM_PER_MPS 125
+
+// Motor command that only overcomes static friction: a DC motor's no-load current
+// (about 6% of the stall current for these gearmotors) is what its own friction
+// costs, so about 6% of full drive passes before a wheel turns.
+#define MOTOR_DEADBAND_PWM 24
+
+#define SPEED_KP 32              // PWM per mm/s * 256
+#define SPEED_KI 8               // PWM per mm/s per control period * 256
+#define SPEED_INTEGRAL_LIMIT 100 // PWM
+
+// Motor driver PWM range.
+#define MAX_MOTOR_PWM 400
+
+/**
+ *
+ * Motion Profile Constants
+ *
+ */
+
+// 1 ramps line-following speed changes through a MotionProfile, 0 jumps to maxSpeed (for slip comparisons).
+#define MOTION_PROFILE 1
+
+// Limits of forward speed changes, in mm/s² and mm/s³. The tyres grip up to about
+// μg ≈ 4900 mm/s² (μ ≈ 0.5, low for silicone on a printed course); accelerating
+// takes half of it and leaves the rest for steering. The jerk limit reaches
+// that acceleration in 0.1 s, ten frames.
+#define PROFILE_ACCELERATION 2500
+#define PROFILE_JERK 25000
+
+// Launch from a stop: gentler acceleration until the launch speed (mm/s² and mm/s).
+// Below 300 mm/s a wheel moves fewer than 11 ticks a frame and its speed is
+// measured late, so slip shows late too; the launch still takes only 0.25 s.
+#define PROFILE_LAUNCH_ACCELERATION 1200
+#define PROFILE_LAUNCH_SPEED 300
+
+// Speed given up when the wheels slip while following (mm/s).
+#define SLIP_BACKOFF 75
+
+// Wheel speed gained beyond the body's, as measured by the accelerometer, that is
+// forward slip (mm/s); the difference leaks away by 1 / 2^FORWARD_SLIP_LEAK_SHIFT per frame.
+#define FORWARD_SLIP_THRESHOLD 60
+#define FORWARD_SLIP_LEAK_SHIFT 4
+
+// Converts mm/s (and its derivatives) to path-following speed units.
+#define TO_SPEED_UNITS(mm) ((mm) * 2 / SPEED_UNIT_MM_PER_S_X2)
+
+/**
+ *
+ * Lap Learning Constants
+ *
+ */
+
+// 1 records the course on the first run and drives learned speed profiles afterwards.
+#define LAP_LEARNING 1
+
+// Courses with their own EEPROM slot, picked on the go screen.
+#define LAP_COURSES 3
+
+// Curvature samples per course; longer courses are downsampled to fit.
+#define LAP_SEGMENTS 128
+
+// Initial segment length, 2^shift mm.
+#define LAP_SEGMENT_SHIFT 6
+
+// Curvature sample resolution: heading change per segment >> shift (65536 per turn).
+#define LAP_CURVATURE_SHIFT 7
+
+// Limits of the learned speed profile (mm/s²). Corners may use about 80% of the
+// μg ≈ 4900 mm/s² grip (see PROFILE_ACCELERATION), the rest is for the line
+// controller's corrections. Braking is planned below PROFILE_ACCELERATION: with
+// the jerk limit ramping in and out, braking from MAX_SPEED to 0.9 m/s for a
+// corner averages about 1700 mm/s², and the plan has to stay behind what is driven.
+#define LAP_LATERAL_ACCELERATION 4000
+#define LAP_BRAKING_ACCELERATION 1500
+
+// Slowest learned speed (path-following units), so spins and tight corners are still driven into.
+#define LAP_MIN_SPEED 40
+
+// Braking starts this far (mm) ahead of a slower segment: the distance covered at
+// MAX_SPEED (1.5 m/s) while the jerk limit ramps braking in (0.1 s).
+#define LAP_LOOKAHEAD 150
+
+// A replayed run whose length is off by more than 1 / 2^shift of the learned length relearns.
+#define LAP_LENGTH_TOLERANCE_SHIFT 3
+
+// First EEPROM byte of the course slots, and the slot marker.
+#define LAP_EEPROM_ADDRESS 0
+#define LAP_EEPROM_MAGIC 0x5A
+
+/**
+ *
+ * Turn Constants
+ *
+ */
+
+// Turn angles (65536 per turn).
+#define TURN_ANGLE_90 16384L
+#define TURN_ANGLE_180 32768L
+
+// Wheel speed while spinning (mm/s): 2 * 600 / WHEEL_DISTANCE = 12.5 rad/s, about
+// 720 dps, well inside the gyro's 2000 dps range. A 180 degree turn (151 mm
+// per wheel) then takes about 0.25 s, under half of TURN_TIMEOUT.
+#define TURN_MAX_SPEED 600
+#define TURN_MIN_SPEED 100     // mm/s, enough to keep the wheels turning
+#define TURN_DECEL_GAIN 28     // mm/s per turn unit * 256 (full speed until ~30 degrees out)
+#define TURN_TOLERANCE 182     // ~1 degree
+#define TURN_LINE_WINDOW 3641  // ~20 degrees, a line seen this close to the target ends the turn
+#define TURN_LINE_TOLERANCE 500 // Line position distance from center that counts as re-acquired
+#define TURN_TIMEOUT 600       // ms, give up if the heading never reaches the target
+
+/**
+ *
+ * Collision Recovery Constants
+ *
+ */
+
+#define RECOVERY_PAUSE 250              // ms standing still after turning around
+#define RECOVERY_MARKER_WINDOW 90000UL  // µs to wait for a fourth dot after the third
+// Search bounds. 1.5 m is a second at MAX_SPEED, further back than a sign passed
+// just before the collision; past it the robot is on the wrong line. The timeout
+// allows two turns of TURN_TIMEOUT, the pause and the marker window, and then
+// the whole distance at 430 mm/s, just above SLOW_MAX_SPEED.
+#define RECOVERY_TIMEOUT 5000000UL      // µs from the collision before the search gives up
+#define RECOVERY_MAX_DISTANCE 1500      // mm driven while searching before giving up
+
+/**
+ *
+ * Mission Constants
+ *
+ */
+
+// 1 runs the mission as coroutines (Coroutine.h), 0 as self-firing events.
+#define MISSION_COROUTINES 0
+
+// Distance past the elevation dots where the robot stops to measure.
+#define MEASUREMENT_DISTANCE 50 // mm
+
 /**
  * 
  * Frame Rate Constants
@@ -62,6 +297,30 @@
 
 #define MILLISECONDS_PER_FRAME 10
 
+// Tasks at or above this priority only run when the frame has slack for their budget.
+#define SCHEDULER_BACKGROUND_PRIORITY 8
+
+// 1 profiles every task and frame (min/mean/max and a histogram, shown and dumped to USB after a run).
+#define FRAME_PROFILER 0
+
+// Profiler histogram: the first bucket ends at 2^PROFILER_BUCKET_SHIFT µs, each next one doubles it.
+#define PROFILER_BUCKET_SHIFT 6
+#define PROFILER_BUCKETS 8
+
+// 1 keeps pending events in a TaskPriorityLinkedList, 0 in per-priority rings.
+#define EVENT_LINKED_LIST 0
+
+// 1 records the last EVENT_TRACE_SIZE event dispatches (shown and dumped to USB after a run).
+#define EVENT_TRACE 0
+#define EVENT_TRACE_SIZE 32
+
+// Maximum number of events dispatched per frame.
+#define EVENT_DISPATCH_BUDGET 4
+
+// Event timer wheel: slot length (2^EVENT_TIMER_SHIFT µs, about a frame) and number of slots (a power of two).
+#define EVENT_TIMER_SHIFT 13
+#define EVENT_TIMER_SLOTS 32
+
 /*
  *
  * Buzzer Notes
@@ -77,6 +336,7 @@
  * 
  */
 typedef unsigned long milliseconds;
+typedef uint32_t microseconds;
 
 /**
  * 
@@ -0,0 +1,214 @@
+/*
+ * File: SpeedControl.cpp
+ *
+ * Description:
+ * This file implements the `SpeedControl` namespace. The control step runs
+ * in the Timer3 compare B interrupt every SPEED_CONTROL_PERIOD, measures
+ * both wheels through `WheelVelocity` and drives the motors with
+ * feedforward + PI, scaled for battery voltage and mapped through a
+ * deadband compensation table. The battery voltage comes from the
+ * background `AnalogSampler`, so every step sees a fresh value for free.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include "SpeedControl.h"
+#include "WheelVelocity.h"
+#include "AnalogSampler.h"
+#include <util/atomic.h>
+
+/*
+ * Motor command needed for each 50 PWM of "effective" drive at the
+ * nominal battery voltage, from 0 to MAX_MOTOR_PWM. The command starts
+ * at the static-friction deadband, MOTOR_DEADBAND_PWM, and rises linearly
+ * to MAX_MOTOR_PWM, so full drive is still full drive. The PI loop takes
+ * up what the straight line misses.
+ */
+#define DEADBAND_TABLE_STEP 50
+#define DEADBAND_POINT(i) (MOTOR_DEADBAND_PWM + \
+        (i) * DEADBAND_TABLE_STEP * (MAX_MOTOR_PWM - MOTOR_DEADBAND_PWM) / MAX_MOTOR_PWM)
+static const int16_t deadbandTable[] PROGMEM = {
+        DEADBAND_POINT(0), DEADBAND_POINT(1), DEADBAND_POINT(2), DEADBAND_POINT(3), DEADBAND_POINT(4),
+        DEADBAND_POINT(5), DEADBAND_POINT(6), DEADBAND_POINT(7), DEADBAND_POINT(8),
+};
+
+static_assert(sizeof(deadbandTable) / sizeof(deadbandTable[0]) == MAX_MOTOR_PWM / DEADBAND_TABLE_STEP + 1,
+              "deadbandTable needs one DEADBAND_POINT per step up to MAX_MOTOR_PWM");
+
+namespace SpeedControl {
+
+    /*
+     * PI controller state for one wheel.
+     */
+    struct WheelController {
+        volatile int16_t target = 0;     // Target velocity (mm/s).
+        int32_t integral = 0;            // Integral term (PWM * 256).
+
+        int16_t step(int16_t measured, uint16_t batteryMillivolts);
+    };
+
+    WheelVelocity velocity;              // Measured wheel velocities.
+    WheelController left;                // Left wheel controller.
+    WheelController right;               // Right wheel controller.
+
+    volatile bool enabled = false;       // Closed loop active.
+}
+
+/*
+ * Maps an effective drive level to a motor command through the
+ * deadband table, preserving the sign.
+ */
+static int16_t compensateDeadband(int16_t drive) {
+    const bool reverse = drive < 0;
+    uint16_t magnitude = reverse ? -drive : drive;
+
+    if (magnitude < 2) {
+        return 0; // Don't chatter around a standstill.
+    }
+    if (magnitude > MAX_MOTOR_PWM) {
+        magnitude = MAX_MOTOR_PWM;
+    }
+
+    const uint8_t index = magnitude / DEADBAND_TABLE_STEP;
+    const uint8_t fraction = magnitude % DEADBAND_TABLE_STEP;
+    int16_t command = pgm_read_word(&deadbandTable[index]);
+    if (fraction != 0) {
+        const int16_t next = pgm_read_word(&deadbandTable[index + 1]);
+        command += (next - command) * fraction / DEADBAND_TABLE_STEP;
+    }
+
+    return reverse ? -command : command;
+}
+
+/*
+ * Reads the battery and guards against a missing pack (USB power only).
+ */
+static uint16_t readBattery() {
+    const uint16_t millivolts = AnalogSampler::batteryMillivolts();
+    return millivolts < BATTERY_NOMINAL_MV / 2 ? BATTERY_NOMINAL_MV : millivolts;
+}
+
+/*
+ * Scales a target down on a sagging battery. Both wheels are scaled by the
+ * same factor, so the path curvature is preserved.
+ */
+static int16_t derate(int16_t target, uint16_t batteryMillivolts) {
+    if (batteryMillivolts >= BATTERY_DERATE_MV) {
+        return target;
+    }
+    return static_cast<int32_t>(target) * batteryMillivolts / BATTERY_DERATE_MV;
+}
+
+/*
+ * Runs one PI step and returns the motor command.
+ */
+int16_t SpeedControl::WheelController::step(int16_t measured, uint16_t batteryMillivolts) {
+    const int16_t goal = derate(target, batteryMillivolts);
+    const int16_t error = goal - measured;
+
+    // Linear drive at the nominal battery voltage: feedforward + P + I.
+    const int32_t feedforward = static_cast<int32_t>(goal) * FEEDFORWARD_PWM_PER_MPS / 1000;
+    const int32_t proportional = (static_cast<int32_t>(error) * SPEED_KP) >> 8;
+    int32_t drive = feedforward + proportional + (integral >> 8);
+
+    // Anti-windup: only integrate when not saturated in the direction of the error.
+    const bool saturated = (drive >= MAX_MOTOR_PWM && error > 0) || (drive <= -MAX_MOTOR_PWM && error < 0);
+    if (!saturated) {
+        integral += static_cast<int32_t>(error) * SPEED_KI;
+        integral = constrain(integral, -(SPEED_INTEGRAL_LIMIT * 256L), SPEED_INTEGRAL_LIMIT * 256L);
+    }
+
+    // Scale for the actual battery voltage, then compensate the deadband.
+    drive = drive * BATTERY_NOMINAL_MV / batteryMillivolts;
+    drive = constrain(drive, -MAX_MOTOR_PWM, MAX_MOTOR_PWM);
+    return compensateDeadband(drive);
+}
+
+/*
+ * Fixed-rate control step. The compare register is advanced first, then
+ * interrupts are re-enabled so encoder edges are never held off by the
+ * control math.
+ */
+ISR(TIMER3_COMPB_vect) {
+    OCR3B += SPEED_CONTROL_PERIOD;
+    sei();
+
+    using namespace SpeedControl;
+
+    velocity.update();
+    if (!enabled) {
+        return;
+    }
+
+    const uint16_t battery = readBattery();
+    const int16_t leftCommand = left.step(velocity.getLeft(), battery);
+    const int16_t rightCommand = right.step(velocity.getRight(), battery);
+    Pololu3piPlus32U4::Motors::setSpeeds(leftCommand, rightCommand);
+}
+
+/*
+ * Starts the control interrupt on Timer3 compare B.
+ */
+void SpeedControl::initialize() {
+    // Timer3 is configured by the encoders; make sure that happened first.
+    Pololu3piPlus32U4::Encoders::init();
+    velocity.reset();
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        OCR3B = TCNT3 + SPEED_CONTROL_PERIOD;
+        TIFR3 = (1 << OCF3B);
+        TIMSK3 |= (1 << OCIE3B);
+    }
+}
+
+/*
+ * Sets the wheel velocity targets and enables closed-loop control.
+ */
+void SpeedControl::setTargets(int16_t leftTarget, int16_t rightTarget) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        left.target = leftTarget;
+        right.target = rightTarget;
+        enabled = true;
+    }
+}
+
+/*
+ * Disables closed-loop control and clears the integrators.
+ */
+void SpeedControl::disable() {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        enabled = false;
+        left.integral = 0;
+        right.integral = 0;
+    }
+}
+
+/*
+ * Converts path-following speed units to mm/s.
+ */
+int16_t SpeedControl::toMillimetresPerSecond(int16_t speed) {
+    return static_cast<int32_t>(speed) * SPEED_UNIT_MM_PER_S_X2 / 2;
+}
+
+/*
+ * Returns the measured left wheel velocity (mm/s).
+ */
+int16_t SpeedControl::getMeasuredLeft() {
+    int16_t measured;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        measured = velocity.getLeft();
+    }
+    return measured;
+}
+
+/*
+ * Returns the measured right wheel velocity (mm/s).
+ */
+int16_t SpeedControl::getMeasuredRight() {
+    int16_t measured;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        measured = velocity.getRight();
+    }
+    return measured;
+}
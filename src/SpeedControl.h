@@ -0,0 +1,64 @@
+/*
+ * File: SpeedControl.h
+ *
+ * Description:
+ * This header file declares the `SpeedControl` namespace, the inner
+ * wheel-velocity loop. A PI controller per wheel runs at a fixed rate from
+ * a Timer3 compare interrupt and turns velocity targets (mm/s) into motor
+ * PWM, using battery-voltage feedforward and a deadband compensation
+ * table. Path following commands velocities; real speed no longer depends
+ * on battery charge or load. When the battery sags below
+ * BATTERY_DERATE_MV, targets are scaled down so the loop stays in range.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+
+namespace SpeedControl {
+
+    /**
+     * Starts the fixed-rate control interrupt.
+     * Must be called once from setup(), after AnalogSampler::start().
+     */
+    void initialize();
+
+    /**
+     * Sets the wheel velocity targets and enables closed-loop control.
+     *
+     * @param left Target velocity of the left wheel (mm/s).
+     * @param right Target velocity of the right wheel (mm/s).
+     */
+    void setTargets(int16_t left, int16_t right);
+
+    /**
+     * Disables closed-loop control so the motors can be driven directly.
+     * The integrators are cleared so the next enable starts cleanly.
+     */
+    void disable();
+
+    /**
+     * Converts path-following speed units (the historical PWM scale) to mm/s.
+     *
+     * @param speed Speed in path-following units.
+     * @return The equivalent wheel velocity in mm/s.
+     */
+    int16_t toMillimetresPerSecond(int16_t speed);
+
+    /**
+     * Retrieves the measured velocity of the left wheel.
+     *
+     * @return The velocity in mm/s.
+     */
+    int16_t getMeasuredLeft();
+
+    /**
+     * Retrieves the measured velocity of the right wheel.
+     *
+     * @return The velocity in mm/s.
+     */
+    int16_t getMeasuredRight();
+}
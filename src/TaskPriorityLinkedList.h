@@ -0,0 +1,175 @@
+/*
+ * File: TaskPriorityLinkedList.h
+ *
+ * Description:
+ * This file defines the `TaskPriorityLinkedList` template, a fixed-size
+ * ready list of tasks indexed by an enum. Every enum value owns one node
+ * in a static array, so nothing is ever allocated, and a task can be
+ * queued at most once. Queued tasks are linked in priority order (lower
+ * value first, FIFO among equals); firing walks to the insertion point,
+ * popping the head is constant time.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "Option.h"
+
+/**
+ * An enum-indexed, intrusive priority list of tasks.
+ *
+ * @tparam TaskEnum Enum naming the tasks; values must be 0 .. NumberOfEnums - 1.
+ * @tparam Task Callable stored per task, invoked as `task(TaskEnum)`.
+ * @tparam NumberOfEnums Number of enum values (at most 255).
+ */
+template<typename TaskEnum, typename Task, size_t NumberOfEnums>
+class TaskPriorityLinkedList {
+    static_assert(NumberOfEnums < 255, "TaskPriorityLinkedList indices are uint8_t");
+
+public:
+    /**
+     * Constructor to initialize an empty list with no tasks set up.
+     */
+    TaskPriorityLinkedList() {
+        for (size_t i = 0; i < NumberOfEnums; i++) {
+            array[i].t = Task();
+            array[i].priority = 0;
+            array[i].queued = false;
+        }
+    }
+
+    /**
+     * Sets the task and priority of an enum value.
+     *
+     * @param id The enum value.
+     * @param t The task to run for it.
+     * @param priority Lower values run first.
+     */
+    void setUpTask(TaskEnum id, Task t, uint8_t priority = 0) {
+        array[id].t = t;
+        array[id].priority = priority;
+    }
+
+    /**
+     * Gets the task set up for an enum value.
+     */
+    Task getTask(TaskEnum id) const {
+        return array[id].t;
+    }
+
+    /**
+     * Queues a task behind all queued tasks of equal or higher priority.
+     * Queueing a task that is already queued has no effect.
+     *
+     * @param id The task to queue.
+     */
+    void fire(TaskEnum id) {
+        Item &item = array[id];
+        if (item.queued) {
+            return;
+        }
+        item.queued = true;
+
+        uint8_t *link = &head;
+        while (*link != END && array[*link].priority <= item.priority) {
+            link = &array[*link].next;
+        }
+        item.next = *link;
+        *link = static_cast<uint8_t>(id);
+        fired += 1;
+    }
+
+    /**
+     * Removes a task from the list if it is queued.
+     *
+     * @param id The task to remove.
+     */
+    void remove(TaskEnum id) {
+        if (!array[id].queued) {
+            return;
+        }
+        uint8_t *link = &head;
+        while (*link != static_cast<uint8_t>(id)) {
+            link = &array[*link].next;
+        }
+        *link = array[id].next;
+        array[id].queued = false;
+        fired -= 1;
+    }
+
+    /**
+     * Removes and returns the first queued task.
+     *
+     * @return The task, or an empty `Option` if none is queued.
+     */
+    Option<TaskEnum> pop() {
+        if (head == END) {
+            return Option<TaskEnum>();
+        }
+        const uint8_t id = head;
+        head = array[id].next;
+        array[id].queued = false;
+        fired -= 1;
+        return Option<TaskEnum>(static_cast<TaskEnum>(id));
+    }
+
+    /**
+     * Pops the first queued task and runs it, if it has one set up.
+     *
+     * @return True if a task was popped.
+     */
+    bool runNext() {
+        Option<TaskEnum> id = pop();
+        if (!id.exists()) {
+            return false;
+        }
+        if (array[id.get()].t) {
+            array[id.get()].t(id.get());
+        }
+        return true;
+    }
+
+    /**
+     * Empties the list. Tasks and priorities stay set up.
+     */
+    void reset() {
+        for (size_t i = 0; i < NumberOfEnums; i++) {
+            array[i].queued = false;
+        }
+        head = END;
+        fired = 0;
+    }
+
+    /**
+     * Checks if a task is queued.
+     */
+    bool isQueued(TaskEnum id) const {
+        return array[id].queued;
+    }
+
+    /**
+     * Gets the number of queued tasks.
+     */
+    uint8_t size() const {
+        return fired;
+    }
+
+private:
+    static const uint8_t END = 0xFF; // No next task.
+
+    /**
+     * Node of one enum value.
+     */
+    struct Item {
+        Task t;              // Task to run.
+        uint8_t next = END;  // Next queued task.
+        uint8_t priority;    // Lower runs first.
+        bool queued;         // True while linked into the list.
+    };
+
+    struct Item array[NumberOfEnums];
+    uint8_t head = END;      // First queued task.
+    uint8_t fired = 0;       // Number of queued tasks.
+};
@@ -0,0 +1,106 @@
+/*
+ * File: TurnController.h
+ *
+ * Description:
+ * This file defines the `TurnController` class, which turns the robot in
+ * place to a target angle measured by the fused gyro/encoder heading.
+ * The spin speed decelerates linearly as the remaining angle shrinks, so
+ * turns stop on target instead of relying on timed delays. The class only
+ * does the angle bookkeeping; the caller feeds it headings and drives the
+ * wheels with the speed it returns.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+#include "FixedTrig.h"
+
+/**
+ * Class for tracking an in-place turn toward a target angle.
+ */
+class TurnController {
+private:
+    int32_t target;                      // Angle to turn, counter-clockwise positive (65536 per turn).
+    int32_t progress;                    // Angle turned so far.
+    FixedTrig::BinaryAngle lastHeading;  // Heading at the previous step.
+    bool done;                           // True once the target is reached.
+
+public:
+    /**
+     * Constructor to initialize an idle controller.
+     */
+    TurnController() : target(0), progress(0), lastHeading(0), done(true) {}
+
+    /**
+     * Starts a new turn.
+     *
+     * @param heading Current heading.
+     * @param angle Angle to turn, counter-clockwise positive (65536 per turn).
+     */
+    void begin(FixedTrig::BinaryAngle heading, int32_t angle) {
+        target = angle;
+        progress = 0;
+        lastHeading = heading;
+        done = false;
+    }
+
+    /**
+     * Advances the turn with a new heading reading.
+     * Headings may wrap; progress is accumulated step by step, so turns
+     * of 180 degrees and more are tracked correctly.
+     *
+     * @param heading Current heading.
+     * @return The spin speed in mm/s, counter-clockwise positive
+     *         (left wheel backward, right wheel forward); 0 when done.
+     */
+    int16_t step(FixedTrig::BinaryAngle heading) {
+        progress += static_cast<int16_t>(heading - lastHeading);
+        lastHeading = heading;
+
+        const int32_t remaining = getRemaining();
+        const bool overshot = (target >= 0) ? remaining < 0 : remaining > 0;
+        if (done || overshot || (remaining < TURN_TOLERANCE && remaining > -TURN_TOLERANCE)) {
+            done = true;
+            return 0;
+        }
+
+        // Decelerate linearly over the last part of the turn.
+        const int32_t magnitude = remaining < 0 ? -remaining : remaining;
+        int32_t speed = magnitude * TURN_DECEL_GAIN >> 8;
+        speed = constrain(speed, TURN_MIN_SPEED, TURN_MAX_SPEED);
+        return remaining < 0 ? -speed : speed;
+    }
+
+    /**
+     * Gets the angle still to turn (65536 per turn).
+     */
+    int32_t getRemaining() const {
+        return target - progress;
+    }
+
+    /**
+     * Checks whether the turn is close enough to its end that a line seen
+     * now is the one being turned onto.
+     */
+    bool inLineWindow() const {
+        const int32_t remaining = getRemaining();
+        return remaining < TURN_LINE_WINDOW && remaining > -TURN_LINE_WINDOW;
+    }
+
+    /**
+     * Ends the turn early, e.g. when the line has been re-acquired.
+     */
+    void finish() {
+        done = true;
+    }
+
+    /**
+     * Checks whether the turn has finished.
+     */
+    bool isDone() const {
+        return done;
+    }
+};
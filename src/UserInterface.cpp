@@ -16,7 +16,9 @@
 
 // Display and button objects for user interaction.
 Pololu3piPlus32U4::OLED display;
+Pololu3piPlus32U4::ButtonA buttonA;
 Pololu3piPlus32U4::ButtonB buttonB;
+Pololu3piPlus32U4::ButtonC buttonC;
 
 // Buzzer object to play sounds.
 typedef Pololu3piPlus32U4::Buzzer Buzzer;
@@ -108,6 +110,35 @@ void UserInterface::showGoScreen() {
     display.clear();               // Clear the screen.
 }
 
+/**
+ * Displays a "Ready to Go" screen with a course selection.
+ *
+ * Shows the course on the bottom line; A and C step through the courses,
+ * B starts the run.
+ *
+ * @param course The course shown first.
+ * @param courses The number of courses.
+ * @return The selected course.
+ */
+uint8_t UserInterface::showGoScreen(uint8_t course, uint8_t courses) {
+    displayCentered("Ready", 1);   // Ready message.
+    displayCentered("<  GO  >", 4); // Go message.
+    while (true) {
+        displayCentered("A< Course " + String(course + 1) + " >C", 7);
+        if (buttonA.getSingleDebouncedPress()) {
+            course = course == 0 ? courses - 1 : course - 1;
+        }
+        if (buttonC.getSingleDebouncedPress()) {
+            course = course + 1 == courses ? 0 : course + 1;
+        }
+        if (buttonB.getSingleDebouncedPress()) {
+            break;
+        }
+    }
+    display.clear();               // Clear the screen.
+    return course;
+}
+
 /**
  * Displays an error message and stops the robot.
  *
@@ -41,6 +41,18 @@ namespace UserInterface {
      */
     void showGoScreen();
 
+    /**
+     * Displays the "Ready to Go" screen with a course selection.
+     *
+     * Buttons A and C step through the courses; button B starts the run
+     * on the one shown.
+     *
+     * @param course The course shown first.
+     * @param courses The number of courses.
+     * @return The selected course.
+     */
+    uint8_t showGoScreen(uint8_t course, uint8_t courses);
+
     /**
      * Displays an error message and stops the robot.
      *
@@ -0,0 +1,126 @@
+/*
+ * File: WheelVelocity.h
+ *
+ * Description:
+ * This file defines the `WheelVelocity` class, which measures the speed of
+ * each wheel from the encoder edge timestamps. Each update divides the new
+ * edges by the time from the last edge of the previous update to the latest
+ * edge, which is the inter-edge period at low speed and counts over time at
+ * high speed.
+ * When no edge arrives the estimate is bounded by the time since the last
+ * edge, so a stopping wheel decays to zero.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "RATS.h"
+#include "Pololu3piPlus32U4Encoders.h"
+
+/**
+ * Class for estimating left and right wheel velocities in mm/s.
+ */
+class WheelVelocity {
+private:
+    typedef Pololu3piPlus32U4::Encoders Encoders;
+
+    /**
+     * Per-wheel estimator state.
+     */
+    struct Wheel {
+        int16_t prevCount = 0;           // Count at the previous update.
+        uint32_t prevEdge = 0;           // Timestamp of the last edge seen at the previous update.
+        int16_t velocity = 0;            // Current estimate (mm/s).
+
+        /**
+         * Updates the estimate from one wheel's part of an edge snapshot.
+         */
+        void update(int16_t count, uint32_t lastEdge, uint32_t period, uint32_t now, int32_t scale) {
+            const int16_t edges = static_cast<uint16_t>(count) - static_cast<uint16_t>(prevCount);
+            prevCount = count;
+
+            if (lastEdge != prevEdge) {
+                uint32_t span = lastEdge - prevEdge;
+                int16_t steps = edges;
+                if (span > ENCODER_STOP_TIMEOUT) {
+                    // The wheel was stopped, only the latest inter-edge period is meaningful.
+                    span = period;
+                    steps = (edges > 0) - (edges < 0);
+                }
+                prevEdge = lastEdge;
+                velocity = span > ENCODER_STOP_TIMEOUT ? 0 : static_cast<int32_t>(steps) * scale / static_cast<int32_t>(span);
+                return;
+            }
+
+            // No new edge: the wheel can be at most one tick per elapsed time.
+            const uint32_t idle = now - lastEdge;
+            if (idle > ENCODER_STOP_TIMEOUT) {
+                velocity = 0;
+                return;
+            }
+            const int32_t bound = scale / static_cast<int32_t>(idle | 1);
+            if (velocity > bound) {
+                velocity = bound;
+            } else if (velocity < -bound) {
+                velocity = -bound;
+            }
+        }
+    };
+
+    const int32_t scale;                 // mm per tick * timer ticks per second.
+    Wheel left;                          // Left wheel estimator.
+    Wheel right;                         // Right wheel estimator.
+
+public:
+    /**
+     * Constructor to initialize the estimator.
+     *
+     * @param mmPerTick Distance traveled per encoder tick (default: same as the odometry).
+     */
+    WheelVelocity(double mmPerTick = (M_PI * 32) / 358.3) :
+            scale(lround(mmPerTick * Encoders::timerTicksPerSecond)) {}
+
+    /**
+     * Resets both estimates to zero and resynchronizes with the encoders.
+     */
+    void reset() {
+        Encoders::EdgeSnapshot snapshot;
+        Encoders::getEdgeSnapshot(snapshot);
+        left = Wheel();
+        right = Wheel();
+        left.prevCount = snapshot.countLeft;
+        left.prevEdge = snapshot.lastEdgeLeft;
+        right.prevCount = snapshot.countRight;
+        right.prevEdge = snapshot.lastEdgeRight;
+    }
+
+    /**
+     * Updates both wheel velocities from a single atomic encoder snapshot.
+     */
+    void update() {
+        Encoders::EdgeSnapshot snapshot;
+        Encoders::getEdgeSnapshot(snapshot);
+        left.update(snapshot.countLeft, snapshot.lastEdgeLeft, snapshot.periodLeft, snapshot.now, scale);
+        right.update(snapshot.countRight, snapshot.lastEdgeRight, snapshot.periodRight, snapshot.now, scale);
+    }
+
+    /**
+     * Gets the left wheel velocity.
+     *
+     * @return The velocity in mm/s, positive forward.
+     */
+    int16_t getLeft() const {
+        return left.velocity;
+    }
+
+    /**
+     * Gets the right wheel velocity.
+     *
+     * @return The velocity in mm/s, positive forward.
+     */
+    int16_t getRight() const {
+        return right.velocity;
+    }
+};
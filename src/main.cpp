@@ -20,35 +20,102 @@
 #include "IRSensor.h"
 #include "UserInterface.h"
 #include "PathFollowing.h"
-#include "Odometry.h"
+#include "FixedOdometry.h"
+#include "SpeedControl.h"
+#include "AnalogSampler.h"
+#include "Landmarks.h"
+#include "CollisionRecovery.h"
 #include "InertialMeasurementUnit.h"
 #include "EventManager.h"
+#include "FrameScheduler.h"
+#include "Clock.h"
 #include "Queue.h"
+#if MISSION_COROUTINES
+#include "Coroutine.h"
+#endif
+#if LAP_LEARNING
+#include "LapLearning.h"
+#endif
 
 #define LOOP for(;;)
 #define EVENT(NAME, CODE) eventManager.setupListener(NAME,[](Event e){ CODE });
+#define URGENT_EVENT(NAME, CODE) eventManager.setupListener(NAME,[](Event e){ CODE }, Urgent);
 #define FIRE(NAME) eventManager.fireEvent(NAME);
+#define TASK(NAME, PERIOD, PRIORITY, BUDGET, CODE) scheduler.addTask(NAME, PERIOD, PRIORITY, BUDGET, [](){ CODE });
 
 /**
  * Global Objects:
- * - Odometry: Tracks the robot's position and orientation.
- * - IMU: Measures pitch and roll for navigation and logging.
+ * - Odometry: Tracks the robot's position and orientation in fixed point.
+ * - IMU: Measures pitch, roll and yaw rate for navigation and logging.
  * - EventManager: Manages event-driven behavior and scheduling.
+ * - FrameScheduler: Runs the game loop tasks at a fixed frame rate.
  * - LogQueue: Stores event logs with associated positional data.
  */
-RobotOdometry odometry = RobotOdometry(WHEEL_DISTANCE, TICKS_PER_REV, WHEEL_DIAMETER);
+FixedOdometry odometry = FixedOdometry(WHEEL_DISTANCE, TICKS_PER_REV, WHEEL_DIAMETER);
 IntertialMeasurementUnit ratsIMU = IntertialMeasurementUnit();
 EventManager eventManager = EventManager();
+FrameScheduler scheduler = FrameScheduler();
 LogQueue<String> logq = LogQueue<String>();
 
+#if LAP_LEARNING
+// Course of the current run, kept for the next one.
+uint8_t course = 0;
+#endif
+
 // Debounce timer for magnetic anomaly detection.
-milliseconds magDebounce = 0;
+microseconds magDebounce = 0;
 
 // Flag for preparing collision avoidance.
 bool prepareCollision = false;
 
+// Cleared when a collision recovery fails, i.e. the run ends short of the end of the course.
+bool runCompleted = true;
+
 // Function declarations.
 void setupEvents();
+void setupTasks();
+void subscribeSigns();
+void collisionTask();
+void logSensorData();
+
+#if MISSION_COROUTINES
+
+/**
+ * Mission coroutines, resumed once per frame:
+ * - elevationSigns: slows at two left dots, stops MEASUREMENT_DISTANCE later to measure, then carries on.
+ * - collisionSigns: slows at three right dots and arms collision recovery.
+ */
+CoroutineRuntime<2> mission;
+
+bool elevationSigns(Coroutine &co) {
+    CO_BEGIN(co);
+    for (;;) {
+        CO_AWAIT(co, IRSensor::fastFound2DotsLeft());
+        Landmarks::observe(IRSensor::CalculateElevation, odometry);
+        PathFollowing::slowDown();
+
+        CO_AWAIT_DISTANCE(co, MEASUREMENT_DISTANCE);
+        PathFollowing::hold(300);
+        CO_AWAIT(co, !PathFollowing::isBusy());
+
+        logSensorData();
+        PathFollowing::start();
+        PathFollowing::speedUp();
+        IRSensor::resetPathSignDetector();
+    }
+    CO_END(co);
+}
+
+bool collisionSigns(Coroutine &co) {
+    CO_BEGIN(co);
+    CO_AWAIT(co, IRSensor::fastFound3DotsRight());
+    Landmarks::observe(IRSensor::TurnRight, odometry);
+    PathFollowing::slowToSpeed(75);
+    prepareCollision = true;
+    CO_END(co);
+}
+
+#endif
 
 /**
  * Initialization routine for the robot.
@@ -59,136 +126,133 @@ void setup() {
     IRSensor::initializeIR();
     UserInterface::initializeUI();
     Wire.begin();
+    Wire.setClock(400000); // Gyro and magnetometer are read every frame.
     ratsIMU.myIMU.init();
     ratsIMU.myIMU.enableDefault();
+    ratsIMU.myIMU.configureForTurnSensing(); // +/- 2000 dps, spins exceed 245 dps.
 
     UserInterface::showWelcomeScreen();
 
     IRSensor::calibrateIR();
     ratsIMU.calibrate();
+    AnalogSampler::start();
+    SpeedControl::initialize();
 
     setupEvents();
+    setupTasks();
+    IRSensor::setSubscriptionSink([](Event e) { FIRE(e) });
+#if MISSION_COROUTINES
+    mission.spawn(elevationSigns);
+    mission.spawn(collisionSigns);
+#endif
 }
 
 /**
  * Main control loop for the robot.
- * - Executes high-priority tasks like scanning sensors and path following.
- * - Handles events and logs data in real-time.
- * - Implements collision detection and recovery logic.
+ * - Runs the game loop tasks at a fixed frame rate (see setupTasks()).
+ * - Shows the run statistics and the logs once the run has ended.
  */
 void loop() {
+#if LAP_LEARNING
+    course = UserInterface::showGoScreen(course, LAP_COURSES);
+    LapLearning::begin(course);
+#else
     UserInterface::showGoScreen();
+#endif
     odometry.reset();
-    Pololu3piPlus32U4::Encoders::getCountsAndResetLeft();
-    Pololu3piPlus32U4::Encoders::getCountsAndResetRight();
-
-    milliseconds sum = 0;
-    unsigned long count = 0;
+    Landmarks::resetResiduals();
+    PathFollowing::resetSlips();
+    runCompleted = true;
 
     IRSensor::resetPathSignDetector();
-    bool eventsPushed = false;
-
-    const milliseconds maxTime = 10; // Maximum frame time for low-priority tasks.
+#if EVENT_TRACE
+    eventManager.clearTrace();
+#endif
 
     PathFollowing::start();
     PathFollowing::speedUp();
 
-    FIRE(CheckFirst2Dots);
-    FIRE(CheckFirst3DotsRight);
+#if MISSION_COROUTINES
+    mission.startAll();
+#else
+    subscribeSigns();
+#endif
 
-    LOOP {
-        const milliseconds frameStart = millis();
+    scheduler.begin();
+    while (scheduler.runFrame());
 
-        // High-priority tasks: sensor scanning, path following, odometry updates.
-        IRSensor::scan();
-        PathFollowing::follow();
-        odometry.update(Pololu3piPlus32U4::Encoders::getCountsLeft(), Pololu3piPlus32U4::Encoders::getCountsRight());
+    // Display runtime data and logs after the loop ends.
+#if LAP_LEARNING
+    const microseconds lapTime = scheduler.getElapsed();
+    const LapLearning::Outcome lap = LapLearning::finish(lapTime, odometry.getDistanceQ8(), runCompleted);
+    Serial.println("lap_ms,best_ms,outcome");
+    Serial.print(static_cast<long>(lapTime / 1000));
+    Serial.print(",");
+    Serial.print(static_cast<long>(LapLearning::getBestLap() / 1000));
+    Serial.print(",");
+    Serial.println(LapLearning::describe(lap));
+    UserInterface::showMessageNotYielding("Lap:" + String(lapTime / 1000) + "ms " +
+                                          LapLearning::describe(lap), 0);
+#endif
+    UserInterface::showMessageNotYielding("FPS:" + String(scheduler.getFrames() * 1000000.0 / scheduler.getElapsed()), 1);
+    UserInterface::showMessageNotYielding("Late:" + String(scheduler.getMissedFrames()) +
+                                          " Ovr:" + String(scheduler.getOverruns(FollowTask)) +
+                                          "/" + String(scheduler.getOverruns(EventTask)), 2);
+#if MISSION_COROUTINES
+    UserInterface::showMessageNotYielding("CO RAM:" + String(mission.ramUsage()) + "B", 3);
+#endif
+    UserInterface::showMessageNotYielding("X:" + String(odometry.getX()), 4);
+    UserInterface::showMessageNotYielding("Y:" + String(odometry.getY()), 5);
+    UserInterface::showMessageNotYielding("Slip:" + String(PathFollowing::getSlips()) +
+                                          " Yaw:" + String(PathFollowing::getYawSlips()), 7);
+    const Landmarks::Residuals residuals = Landmarks::getResiduals();
+    UserInterface::showMessage("LM:" + String(residuals.corrections) +
+                               " avg:" + String(residuals.corrections ? residuals.sum / residuals.corrections : 0) +
+                               " max:" + String(residuals.max), 6);
+    UserInterface::clearScreen();
 
-        // Handle queued events.
-        if (eventsPushed) {
-            while (eventManager.next());
-            eventsPushed = false;
+#if FRAME_PROFILER
+    // Mean and worst run time of every task and of the frame, a page at a time,
+    // with the full table and histograms dumped over USB.
+    const FrameProfiler<NUMBER_OF_PROFILER_STAGES> &profiler = scheduler.getProfiler();
+    const char *const *stageNames = FrameScheduler::getStageNames();
+    profiler.printSummary(Serial, stageNames);
+    for (uint8_t stage = 0; stage < NUMBER_OF_PROFILER_STAGES; stage++) {
+        const uint8_t line = 1 + stage % 7;
+        if (line == 1) {
+            UserInterface::showMessageNotYielding("avg/max us", 0);
         }
-
-        // Magnetic anomaly detection with debounce.
-        if (frameStart - magDebounce > MAG_DEBOUNCE_THRESHOLD) {
-            if (ratsIMU.foundAnamoly().exists()) {
-                logq.add("Magnetic Anomaly", odometry.getPose().x, odometry.getPose().y);
-                magDebounce = millis();
-            }
-        }
-
-        // Collision detection and recovery logic.
-        if (IRSensor::isCollisionDetected() && prepareCollision) {
-            PathFollowing::stop();
-            eventManager.cancelAllEvents();
-            logq.add("Collision Detected", odometry.getPose().x, odometry.getPose().y);
-            PathFollowing::turnAround();
-            PathFollowing::start();
-            IRSensor::resetPathSignDetector();
-            delay(250);
-            PathFollowing::speedUp();
-
-            // Handle path markers during recovery.
-            while (IRSensor::getRemainingDots() != 3) {
-                IRSensor::scan();
-                PathFollowing::follow();
-            }
-
-            milliseconds current = millis();
-            while (IRSensor::getRemainingDots() != 4 && millis() - current < 90) {
-                IRSensor::scan();
-                PathFollowing::follow();
-            }
-
-            // Choose turn direction based on detected markers.
-            if (IRSensor::getRemainingDots() >= 4) {
-                while (!IRSensor::seeingRight()) {
-                    IRSensor::scan();
-                    PathFollowing::follow();
-                }
-                PathFollowing::turnRight();
-                IRSensor::resetPathSignDetectorRight();
-            } else {
-                while (!IRSensor::seeingLeft()) {
-                    IRSensor::scan();
-                    PathFollowing::follow();
-                }
-                PathFollowing::turnLeft();
-                IRSensor::resetPathSignDetectorRight();
-            }
-            prepareCollision = false;
-            IRSensor::resetPathSignDetector();
-            FIRE(CheckFirst2Dots);
-            FIRE(CheckFirst3DotsRight);
+        const String row = String(stageNames[stage]) + " " + String(profiler.getMean(stage)) +
+                           "/" + String(profiler.getMax(stage));
+        if (line == 7 || stage == NUMBER_OF_PROFILER_STAGES - 1) {
+            UserInterface::showMessage(row, line);
+            UserInterface::clearScreen();
+        } else {
+            UserInterface::showMessageNotYielding(row, line);
         }
-
-        // End condition: stop if the robot cannot follow the path.
-        if (!PathFollowing::canFollowPath()) {
-            eventManager.cancelAllEvents();
-            IRSensor::resetPathSignDetector();
-            break;
+    }
+#endif
+
+#if EVENT_TRACE
+    // Worst fire-to-dispatch latency and callback duration of the traced events,
+    // with the full trace dumped over USB.
+    unsigned long maxLatency = 0;
+    unsigned long maxDuration = 0;
+    for (uint8_t i = 0; i < eventManager.traceSize(); i++) {
+        const EventManager::TraceRecord &record = eventManager.getTrace(i);
+        if (record.started - record.fired > maxLatency) {
+            maxLatency = record.started - record.fired;
         }
-
-        // Process low-priority events if time allows.
-        while (eventManager.next()) {
-            if (millis() - frameStart > maxTime) {
-                eventsPushed = true;
-                break;
-            }
+        if (record.duration > maxDuration) {
+            maxDuration = record.duration;
         }
-
-        // Record frame timing.
-        const milliseconds frameTime = millis() - frameStart;
-        sum += frameTime;
-        count += 1;
     }
-
-    // Display runtime data and logs after the loop ends.
-    UserInterface::showMessageNotYielding("FPS:" + String((sum / count) * 100), 2);
-    UserInterface::showMessageNotYielding("X:" + String(odometry.getX()), 4);
-    UserInterface::showMessage("Y:" + String(odometry.getY()), 5);
+    eventManager.dumpTrace(Serial);
+    UserInterface::showMessageNotYielding("Trace:" + String(eventManager.traceSize()), 1);
+    UserInterface::showMessageNotYielding("Lat max:" + String(maxLatency) + "us", 2);
+    UserInterface::showMessage("Dur max:" + String(maxDuration) + "us", 3);
     UserInterface::clearScreen();
+#endif
 
     // Log viewing interface.
     LogQueue<String>::Log *currentLog = logq.getFirst();
@@ -243,62 +307,159 @@ void setupEvents() {
         PathFollowing::start();
     })
 
-    {
-        static milliseconds t0;
-
-        EVENT(SlowDown, {
-            PathFollowing::slowDown();
-            t0 = millis();
-            FIRE(Check5cm);
-        })
-
-        EVENT(Check5cm, {
-            if (millis() - t0 >= 200) {
-                FIRE(Reached5cm);
-            } else {
-                FIRE(Check5cm);
-            }
-        })
-    }
-
-    EVENT(CheckFirst2Dots, {
-        if (IRSensor::fastFound2DotsLeft()) {
-            FIRE(SlowDown);
-        } else {
-            FIRE(CheckFirst2Dots);
-        }
-    })
-
-    EVENT(CheckFirst3DotsRight, {
-        if (IRSensor::fastFound3DotsRight()) {
-            FIRE(PrepareCollision);
-        } else {
-            FIRE(CheckFirst3DotsRight);
-        }
+    URGENT_EVENT(SlowDown, {
+        Landmarks::observe(IRSensor::CalculateElevation, odometry);
+        PathFollowing::slowDown();
+        eventManager.fireAtDistance(Reached5cm, MEASUREMENT_DISTANCE);
     })
 
     EVENT(Reached5cm, {
-        PathFollowing::stop();
-        delay(300);
-        auto orientation = ratsIMU.getOrientation();
-        logq.add(
-                "SENSOR DATA: Pitch: " + String(orientation.x) +
-                " Roll: " + String(orientation.y) +
-                " Reflectance Left: " + String(IRSensor::reflectanceLeft()) +
-                " Reflectance Right: " + String(IRSensor::reflectanceRight()
-                ),
-                odometry.getPose().x,
-                odometry.getPose().y
-        );
+        PathFollowing::hold(300, Measured);
+    });
 
+    URGENT_EVENT(Measured, {
+        logSensorData();
         PathFollowing::start();
         PathFollowing::speedUp();
-        FIRE(CheckFirst2Dots);
-        IRSensor::resetPathSignDetector();
+        IRSensor::resetPathSignDetector(); // Re-arms the SlowDown subscription.
     });
 
-    EVENT(PrepareCollision, {
+    URGENT_EVENT(PrepareCollision, {
+        Landmarks::observe(IRSensor::TurnRight, odometry);
         PathFollowing::slowToSpeed(75);
         prepareCollision = true;
     });
-}
\ No newline at end of file
+}
+
+/**
+ * Subscribes the path sign events, checked once per scan:
+ * - Two dots on the left slow down for a measurement.
+ * - Three dots on the right prepare for the collision.
+ */
+void subscribeSigns() {
+    IRSensor::subscribe<IRSensor::LeftDots, 2>(SlowDown);
+    IRSensor::subscribe<IRSensor::RightDots, 3>(PrepareCollision);
+}
+
+/**
+ * Logs pitch, roll and edge reflectance at the current position.
+ */
+void logSensorData() {
+    auto orientation = ratsIMU.getOrientation();
+    logq.add(
+            "SENSOR DATA: Pitch: " + String(orientation.x) +
+            " Roll: " + String(orientation.y) +
+            " Reflectance Left: " + String(IRSensor::reflectanceLeft()) +
+            " Reflectance Right: " + String(IRSensor::reflectanceRight()
+            ),
+            odometry.getPose().x,
+            odometry.getPose().y
+    );
+}
+
+/**
+ * Registers the game loop tasks with the frame scheduler.
+ * Priorities set the order within a frame; the sensors, controller and
+ * odometry run first so the controller sees a constant frame period.
+ * Budgets are in µs.
+ */
+void setupTasks() {
+    TASK(ScanTask, 1, 0, 2500, {
+        IRSensor::scan();
+    })
+
+    TASK(FollowTask, 1, 1, 2500, {
+        PathFollowing::follow();
+    })
+
+    TASK(OdometryTask, 1, 2, 1000, {
+        odometry.update(ratsIMU.readYawRate());
+        PathFollowing::reportHeadingSlips(odometry.getHeadingFilter().getSlips());
+        PathFollowing::reportAcceleration(ratsIMU.readForwardAcceleration());
+#if LAP_LEARNING
+        LapLearning::record(odometry.getDistanceQ8(), odometry.getEncoderHeading());
+        PathFollowing::limitSpeed(LapLearning::speedAt(odometry.getDistanceQ8()));
+#endif
+    })
+
+    // Completion events are dispatched by EventTask in the same frame.
+    TASK(MotionTask, 1, 3, 2500, {
+        Option<Event> finished = PathFollowing::step(odometry.getHeading());
+        if (finished.exists()) {
+            FIRE(finished.get());
+        }
+    })
+
+    // Fire due timers and distance triggers, then dispatch the events pending now, up to the budget.
+    TASK(EventTask, 1, 4, 1000, {
+        eventManager.advance(Clock::now(), odometry.getDistanceQ8());
+        eventManager.dispatch(EVENT_DISPATCH_BUDGET);
+    })
+
+#if MISSION_COROUTINES
+    TASK(MissionTask, 1, 5, 500, {
+        mission.resume(Clock::now(), odometry.getDistanceQ8());
+    })
+#endif
+
+    scheduler.addTask(CollisionTask, 1, 6, 2500, collisionTask);
+
+    // Magnetic anomaly detection with debounce, in the slack of the frame.
+    TASK(AnomalyTask, 1, SCHEDULER_BACKGROUND_PRIORITY, 1200, {
+        if (Clock::now() - magDebounce > MAG_DEBOUNCE_THRESHOLD) {
+            if (ratsIMU.foundAnamoly().exists()) {
+                logq.add("Magnetic Anomaly", odometry.getPose().x, odometry.getPose().y);
+                magDebounce = Clock::now();
+            }
+        }
+    })
+}
+
+/**
+ * Collision task: starts and steps the collision recovery, logs its
+ * outcome, and stops the run once the path has ended.
+ */
+void collisionTask() {
+    // Collision detection; the recovery then runs alongside the other tasks.
+    if (IRSensor::isCollisionDetected() && prepareCollision) {
+        prepareCollision = false;
+        IRSensor::clearSubscriptions();
+        eventManager.cancelAllEvents();
+#if MISSION_COROUTINES
+        mission.stopAll();
+#endif
+        logq.add("Collision Detected", odometry.getPose().x, odometry.getPose().y);
+        CollisionRecovery::begin();
+    }
+
+    Option<CollisionRecovery::Report> recovery = CollisionRecovery::step(odometry);
+    if (recovery.exists()) {
+        const CollisionRecovery::Report report = recovery.get();
+        logq.add("Recovery " + String(CollisionRecovery::describe(report.outcome)) +
+                 " phase " + String(report.phase) +
+                 " " + String(report.duration) + "ms " + String(report.distance) + "mm",
+                 odometry.getPose().x, odometry.getPose().y);
+        if (report.outcome == CollisionRecovery::Recovered) {
+            IRSensor::resetPathSignDetectorRight();
+            IRSensor::resetPathSignDetector();
+#if MISSION_COROUTINES
+            mission.startAll();
+#else
+            subscribeSigns();
+#endif
+        } else {
+            runCompleted = false;
+        }
+    }
+
+    // End condition: stop if the robot cannot follow the path.
+    if (!PathFollowing::canFollowPath() && !PathFollowing::isBusy()) {
+        IRSensor::clearSubscriptions();
+        eventManager.cancelAllEvents();
+#if MISSION_COROUTINES
+        mission.stopAll();
+#endif
+        IRSensor::resetPathSignDetector();
+        scheduler.stop();
+    }
+}
@@ -0,0 +1,24 @@
+/*
+ * File: Arduino.h
+ *
+ * Description:
+ * Host stand-in for the Arduino core, for the native unit tests. It only
+ * provides what the headers under test use; nothing here talks to
+ * hardware.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <math.h>
+#include "avr/pgmspace.h"
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis();
+unsigned long micros();
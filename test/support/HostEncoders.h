@@ -0,0 +1,96 @@
+/*
+ * File: HostEncoders.h
+ *
+ * Description:
+ * Host definitions of the encoder library functions that the headers
+ * under test call, with the clock driven by the test. turnWheels() stands
+ * in for the encoder ISRs: it moves the counts and, once pose tracking is
+ * on, the per-tick pose the same way. Include it from exactly one file of
+ * a test suite.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "Pololu3piPlus32U4.h"
+#include "FixedTrig.h"
+
+namespace HostEncoders {
+
+    uint32_t micros = 0;                 // What Clock::now() returns (µs).
+    int16_t leftSpeed = 0;               // Last speeds passed to Motors::setSpeeds().
+    int16_t rightSpeed = 0;
+
+    int16_t countLeft = 0;               // Encoder counts, never reset, as on the robot.
+    int16_t countRight = 0;
+    int32_t poseHalfStep = 0;            // Per-tick pose, see enablePoseTracking().
+    uint32_t poseHeading = 0;
+    int32_t poseX = 0;
+    int32_t poseY = 0;
+
+    /*
+     * One tick of the per-tick pose, as in the encoder ISRs.
+     */
+    void poseTick(int8_t direction, int32_t halfStep) {
+        const uint32_t midHeading = poseHeading + halfStep;
+        const int16_t c = FixedTrig::cosQ15(midHeading >> 16);
+        const int16_t s = FixedTrig::sinQ15(midHeading >> 16);
+        poseX += direction > 0 ? c : -c;
+        poseY += direction > 0 ? s : -s;
+        poseHeading = midHeading + halfStep;
+    }
+
+    /*
+     * Turns the wheels by some ticks, interleaving the two encoders' edges.
+     */
+    void turnWheels(int16_t left, int16_t right) {
+        const int8_t leftDirection = left < 0 ? -1 : 1;
+        const int8_t rightDirection = right < 0 ? -1 : 1;
+        int16_t leftTicks = left < 0 ? -left : left;
+        int16_t rightTicks = right < 0 ? -right : right;
+        while (leftTicks > 0 || rightTicks > 0) {
+            if (leftTicks > 0) {
+                countLeft += leftDirection;
+                if (poseHalfStep != 0) {
+                    poseTick(leftDirection, leftDirection > 0 ? -poseHalfStep : poseHalfStep);
+                }
+                leftTicks -= 1;
+            }
+            if (rightTicks > 0) {
+                countRight += rightDirection;
+                if (poseHalfStep != 0) {
+                    poseTick(rightDirection, rightDirection > 0 ? poseHalfStep : -poseHalfStep);
+                }
+                rightTicks -= 1;
+            }
+        }
+    }
+}
+
+uint32_t Pololu3piPlus32U4::Encoders::getMicros() {
+    return HostEncoders::micros;
+}
+
+void Pololu3piPlus32U4::Encoders::enablePoseTracking(uint32_t headingPerTick) {
+    HostEncoders::poseHalfStep = headingPerTick >> 1;
+    HostEncoders::poseHeading = 0;
+    HostEncoders::poseX = 0;
+    HostEncoders::poseY = 0;
+}
+
+void Pololu3piPlus32U4::Encoders::getPoseSnapshot(PoseSnapshot &snapshot) {
+    snapshot.countLeft = HostEncoders::countLeft;
+    snapshot.countRight = HostEncoders::countRight;
+    snapshot.heading = HostEncoders::poseHeading;
+    snapshot.displacementX = HostEncoders::poseX;
+    snapshot.displacementY = HostEncoders::poseY;
+    HostEncoders::poseX = 0;
+    HostEncoders::poseY = 0;
+}
+
+void Pololu3piPlus32U4::Motors::setSpeeds(int16_t left, int16_t right) {
+    HostEncoders::leftSpeed = left;
+    HostEncoders::rightSpeed = right;
+}
@@ -0,0 +1,26 @@
+/*
+ * File: Pololu3piPlus32U4.h
+ *
+ * Description:
+ * Host stand-in for the 3pi+ library, for the native unit tests. The
+ * encoder class is the real header; its functions that touch the timer
+ * or the ISRs are defined by HostEncoders.h where a test needs them.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include "Arduino.h"
+#include "Pololu3piPlus32U4Encoders.h"
+
+namespace Pololu3piPlus32U4 {
+
+    /*
+     * Motor driver that only remembers the last speeds set.
+     */
+    struct Motors {
+        static void setSpeeds(int16_t left, int16_t right);
+    };
+}
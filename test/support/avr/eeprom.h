@@ -0,0 +1,40 @@
+/*
+ * File: avr/eeprom.h
+ *
+ * Description:
+ * Host stand-in for avr-libc's EEPROM access: the 1 KB EEPROM of the
+ * ATmega32U4 is an array the tests can erase and inspect.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace HostEeprom {
+    inline uint8_t *memory() {
+        static uint8_t bytes[1024];
+        return bytes;
+    }
+
+    // Erased EEPROM reads as 0xFF.
+    inline void erase() {
+        memset(memory(), 0xFF, 1024);
+    }
+}
+
+inline void eeprom_read_block(void *destination, const void *source, size_t size) {
+    memcpy(destination, HostEeprom::memory() + reinterpret_cast<uintptr_t>(source), size);
+}
+
+inline void eeprom_update_block(const void *source, void *destination, size_t size) {
+    memcpy(HostEeprom::memory() + reinterpret_cast<uintptr_t>(destination), source, size);
+}
+
+inline void eeprom_update_byte(uint8_t *address, uint8_t value) {
+    HostEeprom::memory()[reinterpret_cast<uintptr_t>(address)] = value;
+}
@@ -0,0 +1,19 @@
+/*
+ * File: avr/pgmspace.h
+ *
+ * Description:
+ * Host stand-in for avr-libc's program memory access: on the host,
+ * PROGMEM data is ordinary memory.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define PROGMEM
+#define pgm_read_byte(address) (*reinterpret_cast<const uint8_t *>(address))
+#define pgm_read_word(address) (*reinterpret_cast<const uint16_t *>(address))
+#define pgm_read_dword(address) (*reinterpret_cast<const uint32_t *>(address))
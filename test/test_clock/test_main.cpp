@@ -0,0 +1,109 @@
+/*
+ * File: test_main.cpp
+ *
+ * Description:
+ * Host unit tests for the overflow extension behind Clock::now():
+ * `Encoders::timerToMicros()`, which combines the Timer3 overflow count,
+ * TCNT3 and the TOV3 flag read in one critical section. A simulated timer
+ * checks readings that straddle an overflow whose interrupt has not run
+ * yet, and the wrap of the 32-bit microsecond clock.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include <unity.h>
+#include "Pololu3piPlus32U4Encoders.h"
+#include "RATS.h"
+
+typedef Pololu3piPlus32U4::Encoders Encoders;
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+/*
+ * Reads the simulated clock the way getMicros() does.
+ *
+ * ticks: Timer3 ticks (2 MHz) since start when the critical section starts.
+ * serviced: Overflows whose interrupt has run by then.
+ * tcntDelay: Ticks until TCNT3 is read.
+ * flagDelay: Ticks from reading TCNT3 until TOV3 is read.
+ */
+static uint32_t readClock(uint64_t ticks, uint32_t serviced, uint8_t tcntDelay, uint8_t flagDelay) {
+    const uint64_t tcntRead = ticks + tcntDelay;
+    const uint64_t flagRead = tcntRead + flagDelay;
+    const bool pending = (flagRead >> 16) > serviced;
+    return Encoders::timerToMicros(serviced, static_cast<uint16_t>(tcntRead), pending);
+}
+
+void test_counts_and_timer_combine_to_microseconds(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, Encoders::timerToMicros(0, 0, false));
+    TEST_ASSERT_EQUAL_UINT32(0x7FFF, Encoders::timerToMicros(0, 0xFFFF, false));
+    TEST_ASSERT_EQUAL_UINT32((5UL << 15) | 0x091A, Encoders::timerToMicros(5, 0x1234, false));
+}
+
+void test_wrapped_counter_with_pending_overflow_counts_it(void) {
+    // TCNT3 wrapped to a small value, but the overflow interrupt has not run.
+    TEST_ASSERT_EQUAL_UINT32((6UL << 15) | 2, Encoders::timerToMicros(5, 4, true));
+}
+
+void test_flag_set_after_reading_a_large_count_is_ignored(void) {
+    // TCNT3 was read just before the wrap; the flag was set after the read.
+    TEST_ASSERT_EQUAL_UINT32((5UL << 15) | 0x7FFF, Encoders::timerToMicros(5, 0xFFFE, true));
+}
+
+void test_reads_straddling_tov3_are_exact(void) {
+    for (uint32_t overflow = 1; overflow < 4; overflow++) {
+        const uint64_t boundary = static_cast<uint64_t>(overflow) << 16;
+        for (int32_t offset = -16; offset < 16; offset++) {
+            const uint64_t ticks = boundary + offset;
+            // The interrupt for the boundary may or may not have run before the critical section.
+            const uint32_t latest = ticks >> 16;
+            const uint32_t lagging = offset >= 0 ? latest - 1 : latest;
+            for (uint8_t tcntDelay = 0; tcntDelay < 6; tcntDelay++) {
+                for (uint8_t flagDelay = 0; flagDelay < 6; flagDelay++) {
+                    const uint32_t expected = (ticks + tcntDelay) >> 1;
+                    TEST_ASSERT_EQUAL_UINT32(expected, readClock(ticks, latest, tcntDelay, flagDelay));
+                    TEST_ASSERT_EQUAL_UINT32(expected, readClock(ticks, lagging, tcntDelay, flagDelay));
+                }
+            }
+        }
+    }
+}
+
+void test_clock_is_monotonic_over_many_overflows(void) {
+    uint32_t previous = readClock(0, 0, 0, 0);
+    for (uint64_t ticks = 1; ticks < (20UL << 16); ticks += 997) {
+        const uint32_t now = readClock(ticks, ticks >> 16, 3, 2);
+        TEST_ASSERT_TRUE(static_cast<int32_t>(now - previous) > 0);
+        previous = now;
+    }
+}
+
+void test_microseconds_wrap_at_32_bits(void) {
+    // 2^32 µs is 2^33 ticks, i.e. 2^17 overflows.
+    const uint64_t wrap = 1ULL << 33;
+    const uint32_t before = readClock(wrap - 20, (wrap - 20) >> 16, 0, 0);
+    const uint32_t after = readClock(wrap + 20, (wrap >> 16) - 1, 0, 0);
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFF6UL, before);
+    TEST_ASSERT_EQUAL_UINT32(10, after);
+
+    // Times are compared by subtraction, which stays right across the wrap.
+    const microseconds elapsed = after - before;
+    TEST_ASSERT_EQUAL_UINT32(20, elapsed);
+    TEST_ASSERT_TRUE(static_cast<int32_t>(after - before) > 0);
+}
+
+int main(int argc, char **argv) {
+    (void) argc;
+    (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_counts_and_timer_combine_to_microseconds);
+    RUN_TEST(test_wrapped_counter_with_pending_overflow_counts_it);
+    RUN_TEST(test_flag_set_after_reading_a_large_count_is_ignored);
+    RUN_TEST(test_reads_straddling_tov3_are_exact);
+    RUN_TEST(test_clock_is_monotonic_over_many_overflows);
+    RUN_TEST(test_microseconds_wrap_at_32_bits);
+    return UNITY_END();
+}
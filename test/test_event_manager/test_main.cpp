@@ -0,0 +1,216 @@
+/*
+ * File: test_main.cpp
+ *
+ * Description:
+ * Host unit tests for `EventManager` on its FIFO rings (EVENT_LINKED_LIST
+ * clear): firing order within a class, urgent events first, firing a
+ * pending event again, cancellation, the dispatch budget, and dispatch
+ * order matching a reference queue on a long pseudo-random run. The
+ * linked list backend has its own suite (test_task_list), and
+ * research/event_benchmark.sh times both against the original scan.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include <unity.h>
+#include "RATS.h"
+
+// Build the manager on the rings, whatever the firmware default is.
+#undef EVENT_LINKED_LIST
+#define EVENT_LINKED_LIST 0
+#undef EVENT_TRACE
+#define EVENT_TRACE 0
+
+#include "EventManager.h"
+
+// Order in which callbacks ran.
+static uint8_t ran[512];
+static uint16_t ranCount = 0;
+
+static void recordEvent(Event event) {
+    ran[ranCount++] = event;
+}
+
+void setUp(void) {
+    ranCount = 0;
+}
+
+void tearDown(void) {}
+
+void test_dispatch_follows_firing_order(void) {
+    EventManager manager;
+    const Event fired[] = {TurnRight, SlowDown, TakeLeft, SpeedUp, Reached5cm};
+    for (Event event : fired) {
+        manager.setupListener(event, recordEvent);
+        manager.fireEvent(event);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(5, manager.dispatch(NUMBER_OF_EVENTS));
+    TEST_ASSERT_EQUAL_UINT16(5, ranCount);
+    for (uint8_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(fired[i], ran[i]);
+    }
+}
+
+void test_urgent_events_go_first(void) {
+    EventManager manager;
+    manager.setupListener(SlowDown, recordEvent);
+    manager.setupListener(SpeedUp, recordEvent);
+    manager.setupListener(Collision, recordEvent, Urgent);
+    manager.setupListener(Measured, recordEvent, Urgent);
+
+    manager.fireEvent(SlowDown);
+    manager.fireEvent(Measured);
+    manager.fireEvent(SpeedUp);
+    manager.fireEvent(Collision);
+
+    TEST_ASSERT_EQUAL_UINT8(4, manager.dispatch(NUMBER_OF_EVENTS));
+    TEST_ASSERT_EQUAL(Measured, ran[0]);
+    TEST_ASSERT_EQUAL(Collision, ran[1]);
+    TEST_ASSERT_EQUAL(SlowDown, ran[2]);
+    TEST_ASSERT_EQUAL(SpeedUp, ran[3]);
+}
+
+void test_firing_a_pending_event_keeps_its_place(void) {
+    EventManager manager;
+    manager.setupListener(SlowDown, recordEvent);
+    manager.setupListener(SpeedUp, recordEvent);
+
+    manager.fireEvent(SlowDown);
+    manager.fireEvent(SpeedUp);
+    manager.fireEvent(SlowDown);
+
+    TEST_ASSERT_EQUAL_UINT8(2, manager.dispatch(NUMBER_OF_EVENTS));
+    TEST_ASSERT_EQUAL(SlowDown, ran[0]);
+    TEST_ASSERT_EQUAL(SpeedUp, ran[1]);
+}
+
+void test_cancelled_events_are_skipped(void) {
+    EventManager manager;
+    manager.setupListener(SlowDown, recordEvent);
+    manager.setupListener(SpeedUp, recordEvent);
+    manager.setupListener(TurnLeft, recordEvent);
+
+    manager.fireEvent(SlowDown);
+    manager.fireEvent(SpeedUp);
+    manager.fireEvent(TurnLeft);
+    manager.cancel(SlowDown);
+    manager.cancel(TurnLeft);
+    TEST_ASSERT_FALSE(manager.isPending(SlowDown));
+
+    // Firing a cancelled event again revives it where it was.
+    manager.fireEvent(TurnLeft);
+    TEST_ASSERT_TRUE(manager.isPending(TurnLeft));
+
+    TEST_ASSERT_EQUAL_UINT8(2, manager.dispatch(NUMBER_OF_EVENTS));
+    TEST_ASSERT_EQUAL_UINT16(2, ranCount);
+    TEST_ASSERT_EQUAL(SpeedUp, ran[0]);
+    TEST_ASSERT_EQUAL(TurnLeft, ran[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, manager.dispatch(NUMBER_OF_EVENTS));
+}
+
+void test_budget_leaves_the_rest_for_the_next_frame(void) {
+    EventManager manager;
+    for (uint8_t e = 0; e < 6; e++) {
+        manager.setupListener(Event(e), recordEvent);
+        manager.fireEvent(Event(e));
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(4, manager.dispatch(4));
+    TEST_ASSERT_TRUE(manager.isPending(Event(4)));
+    TEST_ASSERT_EQUAL_UINT8(2, manager.dispatch(4));
+    TEST_ASSERT_EQUAL_UINT8(0, manager.dispatch(4));
+    for (uint8_t e = 0; e < 6; e++) {
+        TEST_ASSERT_EQUAL(e, ran[e]);
+    }
+}
+
+static EventManager *chained = nullptr;
+
+static void refireSelf(Event event) {
+    recordEvent(event);
+    chained->fireEvent(event);
+}
+
+void test_self_firing_event_runs_once_per_dispatch(void) {
+    EventManager manager;
+    chained = &manager;
+    manager.setupListener(SpeedUp, refireSelf);
+    manager.setupListener(SlowDown, recordEvent);
+
+    manager.fireEvent(SpeedUp);
+    manager.fireEvent(SlowDown);
+    TEST_ASSERT_EQUAL_UINT8(2, manager.dispatch(NUMBER_OF_EVENTS));
+    TEST_ASSERT_EQUAL_UINT8(1, manager.dispatch(NUMBER_OF_EVENTS));
+    TEST_ASSERT_EQUAL(SpeedUp, ran[0]);
+    TEST_ASSERT_EQUAL(SlowDown, ran[1]);
+    TEST_ASSERT_EQUAL(SpeedUp, ran[2]);
+    TEST_ASSERT_TRUE(manager.isPending(SpeedUp));
+}
+
+void test_matches_a_reference_queue_on_a_random_run(void) {
+    EventManager manager;
+    for (uint8_t e = 0; e < NUMBER_OF_EVENTS; e++) {
+        manager.setupListener(Event(e), recordEvent, e % 3 == 0 ? Urgent : Normal);
+    }
+
+    // Reference: one FIFO per class, an event at most once.
+    uint8_t urgent[NUMBER_OF_EVENTS];
+    uint8_t normal[NUMBER_OF_EVENTS];
+    uint8_t urgentCount = 0;
+    uint8_t normalCount = 0;
+    uint8_t expected[sizeof(ran)];
+    uint16_t expectedCount = 0;
+
+    uint32_t seed = 2024;
+    for (int frame = 0; frame < 200; frame++) {
+        for (uint8_t i = 0; i < 3; i++) {
+            seed = seed * 1103515245UL + 12345UL;
+            const uint8_t event = (seed >> 16) % NUMBER_OF_EVENTS;
+            manager.fireEvent(Event(event));
+
+            uint8_t *queue = event % 3 == 0 ? urgent : normal;
+            uint8_t &count = event % 3 == 0 ? urgentCount : normalCount;
+            bool pending = false;
+            for (uint8_t j = 0; j < count; j++) {
+                pending |= queue[j] == event;
+            }
+            if (!pending) {
+                queue[count++] = event;
+            }
+        }
+
+        const uint8_t budget = 1 + frame % 3;
+        const uint8_t dispatched = manager.dispatch(budget);
+        uint8_t taken = 0;
+        while (taken < budget && urgentCount + normalCount > 0) {
+            uint8_t *queue = urgentCount > 0 ? urgent : normal;
+            uint8_t &count = urgentCount > 0 ? urgentCount : normalCount;
+            expected[expectedCount++] = queue[0];
+            for (uint8_t j = 1; j < count; j++) {
+                queue[j - 1] = queue[j];
+            }
+            count -= 1;
+            taken += 1;
+        }
+        TEST_ASSERT_EQUAL_UINT8(taken, dispatched);
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(expectedCount, ranCount);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, ran, expectedCount);
+}
+
+int main(int argc, char **argv) {
+    (void) argc;
+    (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_dispatch_follows_firing_order);
+    RUN_TEST(test_urgent_events_go_first);
+    RUN_TEST(test_firing_a_pending_event_keeps_its_place);
+    RUN_TEST(test_cancelled_events_are_skipped);
+    RUN_TEST(test_budget_leaves_the_rest_for_the_next_frame);
+    RUN_TEST(test_self_firing_event_runs_once_per_dispatch);
+    RUN_TEST(test_matches_a_reference_queue_on_a_random_run);
+    return UNITY_END();
+}
@@ -0,0 +1,202 @@
+/*
+ * File: test_main.cpp
+ *
+ * Description:
+ * Host unit tests for `HeadingFilter` on synthetic gyro and encoder
+ * streams: agreeing sensors through a turn, wheel slip (the encoder
+ * heading jumps while the gyro does not), small disagreements blending
+ * in, the zero-velocity bias estimate (only with both wheels stopped,
+ * not while driving straight), and the encoder fallback after a gap
+ * longer than HEADING_MAX_DT_US.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include <unity.h>
+#include "HeadingFilter.h"
+
+static const uint32_t FRAME = 10000;     // Update period (µs).
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+/*
+ * Converts degrees to the filter's 2^32-per-turn units.
+ */
+static uint32_t degrees(double angle) {
+    return static_cast<uint32_t>(static_cast<int64_t>(llround(angle / 360.0 * 4294967296.0)));
+}
+
+/*
+ * Heading change of one frame at a gyro rate (0.07 dps per digit).
+ */
+static uint32_t gyroTurn(int16_t rate, uint32_t dt) {
+    return degrees(rate * 0.07 * dt / 1000000.0);
+}
+
+/*
+ * Signed difference between two headings, in degrees.
+ */
+static float headingError(uint32_t actual, uint32_t expected) {
+    return static_cast<int32_t>(actual - expected) * (360.0 / 4294967296.0);
+}
+
+void test_agreeing_sensors_track_the_turn(void) {
+    HeadingFilter filter;
+    uint32_t truth = 0;
+    for (int i = 0; i < 200; i++) {
+        truth += gyroTurn(1000, FRAME);
+        filter.update(truth, false, 1000, FRAME);
+    }
+    // 200 frames at 70 dps is 140 degrees.
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, headingError(filter.getHeading(), truth));
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 140.0f, headingError(filter.getHeading(), 0));
+    TEST_ASSERT_EQUAL_UINT16(0, filter.getSlips());
+}
+
+void test_encoder_jump_without_rotation_is_slip(void) {
+    HeadingFilter filter;
+    uint32_t encoder = 0;
+    uint32_t truth = 0;
+    for (int i = 0; i < 50; i++) {
+        truth += gyroTurn(500, FRAME);
+        encoder = truth;
+        filter.update(encoder, false, 500, FRAME);
+    }
+
+    // One wheel spins: the encoders see 5 degrees the gyro does not.
+    truth += gyroTurn(500, FRAME);
+    encoder = truth + degrees(5);
+    filter.update(encoder, false, 500, FRAME);
+    TEST_ASSERT_EQUAL_UINT16(1, filter.getSlips());
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, headingError(filter.getHeading(), truth));
+
+    // The slip is absorbed: the encoder's offset view no longer pulls the heading.
+    for (int i = 0; i < 300; i++) {
+        truth += gyroTurn(500, FRAME);
+        encoder += gyroTurn(500, FRAME);
+        filter.update(encoder, false, 500, FRAME);
+    }
+    TEST_ASSERT_EQUAL_UINT16(1, filter.getSlips());
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, headingError(filter.getHeading(), truth));
+}
+
+void test_jump_while_gyro_reads_still_is_slip(void) {
+    HeadingFilter filter;
+    filter.update(degrees(-20), false, 0, FRAME);
+    TEST_ASSERT_EQUAL_UINT16(1, filter.getSlips());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, headingError(filter.getHeading(), 0));
+}
+
+void test_small_disagreement_blends_toward_the_encoders(void) {
+    HeadingFilter filter;
+    uint32_t encoder = 0;
+    // Half a degree per frame more than the gyro says: below the slip threshold.
+    for (int i = 0; i < 4; i++) {
+        encoder += gyroTurn(300, FRAME) + degrees(0.5);
+        filter.update(encoder, false, 300, FRAME);
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, filter.getSlips());
+
+    const float behind = headingError(filter.getHeading(), encoder);
+    TEST_ASSERT_TRUE(behind < 0.0f);
+    TEST_ASSERT_TRUE(behind > -2.0f);
+
+    // Once the sensors agree again, the heading closes the gap.
+    for (int i = 0; i < 2000; i++) {
+        encoder += gyroTurn(300, FRAME);
+        filter.update(encoder, false, 300, FRAME);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, headingError(filter.getHeading(), encoder));
+}
+
+void test_bias_is_learned_standing_still(void) {
+    HeadingFilter filter;
+    for (int i = 0; i < 400; i++) {
+        filter.update(0, true, 25, FRAME);
+    }
+    TEST_ASSERT_INT_WITHIN(25 * 256 / 20, 25 * 256, filter.getBias());
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, headingError(filter.getHeading(), 0));
+
+    // A turn read through the same offset gyro comes out right.
+    uint32_t truth = 0;
+    for (int i = 0; i < 100; i++) {
+        truth += gyroTurn(800, FRAME);
+        filter.update(truth, false, 800 + 25, FRAME);
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, filter.getSlips());
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, headingError(filter.getHeading(), truth));
+}
+
+void test_driving_straight_does_not_learn_a_bias(void) {
+    HeadingFilter filter;
+    // Both wheels turn at the same rate, so the encoder heading holds
+    // still while the gyro reads a steady 2.1 dps.
+    for (int i = 0; i < 400; i++) {
+        filter.update(0, false, 30, FRAME);
+    }
+    TEST_ASSERT_EQUAL_INT32(0, filter.getBias());
+    TEST_ASSERT_EQUAL_UINT16(0, filter.getSlips());
+
+    // The gyro's view is kept, pulled back toward the encoders: it settles
+    // near 0.021 degrees per frame * 2^HEADING_BLEND_SHIFT ahead. Zeroing
+    // the gyro would have held the heading at exactly 0.
+    TEST_ASSERT_TRUE(headingError(filter.getHeading(), 0) > 1.0f);
+    TEST_ASSERT_TRUE(headingError(filter.getHeading(), 0) < 6.0f);
+
+    // Once the wheels stop, the same reading is learned as bias.
+    for (int i = 0; i < 400; i++) {
+        filter.update(0, true, 30, FRAME);
+    }
+    TEST_ASSERT_INT_WITHIN(30 * 256 / 20, 30 * 256, filter.getBias());
+}
+
+void test_reset_keeps_the_bias(void) {
+    HeadingFilter filter;
+    for (int i = 0; i < 400; i++) {
+        filter.update(0, true, -40, FRAME);
+    }
+    filter.update(degrees(30), false, 0, FRAME);
+    TEST_ASSERT_EQUAL_UINT16(1, filter.getSlips());
+
+    const int32_t bias = filter.getBias();
+    filter.reset(degrees(90));
+    TEST_ASSERT_EQUAL_UINT16(0, filter.getSlips());
+    TEST_ASSERT_EQUAL_INT32(bias, filter.getBias());
+    TEST_ASSERT_EQUAL_UINT32(degrees(90), filter.getHeading());
+
+    filter.resetBias();
+    TEST_ASSERT_EQUAL_INT32(0, filter.getBias());
+}
+
+void test_long_gap_falls_back_to_the_encoders(void) {
+    HeadingFilter filter;
+    filter.update(0, true, 0, FRAME);
+
+    // A blocking 90 degree turn: one stale gyro sample can't stand for it.
+    filter.update(degrees(90), false, 0, HEADING_MAX_DT_US + 1);
+    TEST_ASSERT_EQUAL_UINT16(0, filter.getSlips());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 90.0f, headingError(filter.getHeading(), 0));
+
+    // At the limit, the gyro is still trusted and the jump is slip.
+    filter.update(degrees(180), false, 0, HEADING_MAX_DT_US);
+    TEST_ASSERT_EQUAL_UINT16(1, filter.getSlips());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 90.0f, headingError(filter.getHeading(), 0));
+}
+
+int main(int argc, char **argv) {
+    (void) argc;
+    (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_agreeing_sensors_track_the_turn);
+    RUN_TEST(test_encoder_jump_without_rotation_is_slip);
+    RUN_TEST(test_jump_while_gyro_reads_still_is_slip);
+    RUN_TEST(test_small_disagreement_blends_toward_the_encoders);
+    RUN_TEST(test_bias_is_learned_standing_still);
+    RUN_TEST(test_driving_straight_does_not_learn_a_bias);
+    RUN_TEST(test_reset_keeps_the_bias);
+    RUN_TEST(test_long_gap_falls_back_to_the_encoders);
+    return UNITY_END();
+}
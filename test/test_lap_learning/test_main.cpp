@@ -0,0 +1,165 @@
+/*
+ * File: test_main.cpp
+ *
+ * Description:
+ * Host unit tests for `LapLearning` fed by `FixedOdometry`, across runs as
+ * main drives them: a learning run, then replays of the same course that
+ * start with the encoder counts left over from earlier runs. The replay
+ * has to index its profile from the start of the run (slow in the bend,
+ * fast on the straights) and come out Replayed, not Mismatch; a run of
+ * another length is a mismatch and forgets the course.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include <unity.h>
+#include "FixedOdometry.h"
+#include "HostEncoders.h"
+
+// The native build leaves src/ out: build the namespace under test here.
+#include "LapLearning.cpp"
+
+// Stand-in for the one SpeedControl function LapLearning uses.
+int16_t SpeedControl::toMillimetresPerSecond(int16_t speed) {
+    return static_cast<int32_t>(speed) * SPEED_UNIT_MM_PER_S_X2 / 2;
+}
+
+static const microseconds FIRST_LAP = 9000000;
+static const microseconds SECOND_LAP = 7000000;
+
+// The course, in frames of constant wheel ticks: straight, left bend, straight.
+static const int16_t COURSE[][3] = {{10, 10, 150}, {8, 12, 150}, {10, 10, 150}};
+
+/*
+ * A run along the course, with the speed limits seen at its start and
+ * halfway along each leg.
+ */
+struct Run {
+    FixedOdometry odometry;
+    int16_t atStart = 0;
+    int16_t halfway[3];
+
+    Run() {
+        odometry.reset();
+        odometry.update();
+        atStart = LapLearning::speedAt(odometry.getDistanceQ8());
+    }
+
+    /*
+     * Drives the first `legs` legs of the course, recording and reading
+     * the profile each frame as main does.
+     */
+    void drive(uint8_t legs) {
+        for (uint8_t leg = 0; leg < legs; leg++) {
+            for (int16_t i = 0; i < COURSE[leg][2]; i++) {
+                HostEncoders::turnWheels(COURSE[leg][0], COURSE[leg][1]);
+                odometry.update();
+                LapLearning::record(odometry.getDistanceQ8(), odometry.getEncoderHeading());
+                if (i == COURSE[leg][2] / 2) {
+                    halfway[leg] = LapLearning::speedAt(odometry.getDistanceQ8());
+                }
+            }
+        }
+    }
+
+    LapLearning::Outcome finish(microseconds lapTime) {
+        return LapLearning::finish(lapTime, odometry.getDistanceQ8(), true);
+    }
+};
+
+void setUp(void) {
+    HostEeprom::erase();
+    HostEncoders::countLeft = 0;
+    HostEncoders::countRight = 0;
+    HostEncoders::poseHalfStep = 0;
+
+    // Calibration spin and a run on another course since power-on.
+    HostEncoders::turnWheels(-2000, 2000);
+    HostEncoders::turnWheels(3000, 3100);
+}
+
+void tearDown(void) {}
+
+void test_learned_course_replays_from_the_start(void) {
+    LapLearning::begin(0);
+    TEST_ASSERT_TRUE(LapLearning::isLearning());
+    {
+        Run learning;
+        learning.drive(3);
+        TEST_ASSERT_EQUAL(LapLearning::Learned, learning.finish(FIRST_LAP));
+    }
+
+    // The robot is carried back to the start line, wheels turning.
+    HostEncoders::turnWheels(-700, -650);
+
+    LapLearning::begin(0);
+    TEST_ASSERT_FALSE(LapLearning::isLearning());
+    Run replay;
+    TEST_ASSERT_EQUAL_INT16(LapLearning::speedAt(0), replay.atStart);
+    replay.drive(3);
+
+    // Slower through the bend than on either straight.
+    TEST_ASSERT_TRUE(replay.halfway[1] >= LAP_MIN_SPEED);
+    TEST_ASSERT_TRUE(replay.halfway[1] < replay.halfway[0]);
+    TEST_ASSERT_TRUE(replay.halfway[1] < replay.halfway[2]);
+
+    TEST_ASSERT_EQUAL(LapLearning::Replayed, replay.finish(SECOND_LAP));
+    TEST_ASSERT_EQUAL_UINT32(SECOND_LAP, LapLearning::getBestLap());
+}
+
+void test_best_lap_survives_the_next_begin(void) {
+    LapLearning::begin(1);
+    Run learning;
+    learning.drive(3);
+    learning.finish(FIRST_LAP);
+
+    const microseconds laps[] = {SECOND_LAP, FIRST_LAP};
+    for (microseconds lap : laps) {
+        HostEncoders::turnWheels(-1000, -1000);
+        LapLearning::begin(1);
+        Run replay;
+        replay.drive(3);
+        TEST_ASSERT_EQUAL(LapLearning::Replayed, replay.finish(lap));
+    }
+    LapLearning::begin(1);
+    TEST_ASSERT_EQUAL_UINT32(SECOND_LAP, LapLearning::getBestLap());
+}
+
+void test_run_of_another_length_is_a_mismatch(void) {
+    LapLearning::begin(2);
+    Run learning;
+    learning.drive(3);
+    learning.finish(FIRST_LAP);
+
+    LapLearning::begin(2);
+    Run shortcut;
+    shortcut.drive(2);
+    TEST_ASSERT_EQUAL(LapLearning::Mismatch, shortcut.finish(SECOND_LAP));
+
+    // The course is forgotten and learned again.
+    LapLearning::begin(2);
+    TEST_ASSERT_TRUE(LapLearning::isLearning());
+}
+
+void test_incomplete_run_saves_nothing(void) {
+    LapLearning::begin(0);
+    Run learning;
+    learning.drive(2);
+    TEST_ASSERT_EQUAL(LapLearning::Incomplete,
+                      LapLearning::finish(FIRST_LAP, learning.odometry.getDistanceQ8(), false));
+
+    LapLearning::begin(0);
+    TEST_ASSERT_TRUE(LapLearning::isLearning());
+}
+
+int main(int argc, char **argv) {
+    (void) argc;
+    (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_learned_course_replays_from_the_start);
+    RUN_TEST(test_best_lap_survives_the_next_begin);
+    RUN_TEST(test_run_of_another_length_is_a_mismatch);
+    RUN_TEST(test_incomplete_run_saves_nothing);
+    return UNITY_END();
+}
@@ -0,0 +1,229 @@
+/*
+ * File: test_main.cpp
+ *
+ * Description:
+ * Host unit tests for `FixedOdometry`'s frame-level update(left, right)
+ * against the floating point `RobotOdometry` it replaces. Both are fed the
+ * same encoder counts along straight, arc, spin and S-shaped trajectories,
+ * and across the 16-bit counter wraparound; the fixed-point pose has to
+ * stay within half a millimetre and 0.03 degrees of the reference.
+ *
+ * The firmware's update() reads snapshots of the per-tick pose the encoder
+ * ISRs keep (simulated by HostEncoders). Those tests start runs with the
+ * counts left over from earlier driving, which reset() must not count,
+ * and check that the gyro bias is only learned with both wheels stopped.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include <unity.h>
+#include "FixedOdometry.h"
+#include "Odometry.h"
+#include "HostEncoders.h"
+
+// Largest pose difference allowed after a trajectory (mm and radians).
+static const float POSITION_TOLERANCE = 0.5f;
+static const float THETA_TOLERANCE = 0.0005f;
+
+static const double MM_PER_TICK = (M_PI * 32) / 358.3;
+
+void setUp(void) {
+    HostEncoders::countLeft = 0;
+    HostEncoders::countRight = 0;
+    HostEncoders::poseHalfStep = 0;
+}
+
+void tearDown(void) {}
+
+/*
+ * Difference of two angles, wrapped to [-π, π).
+ */
+static float angleDifference(double a, double b) {
+    return atan2(sin(a - b), cos(a - b));
+}
+
+/*
+ * Drives both odometries through `frames` frames of constant tick rates,
+ * from the counts they saw last, and compares the resulting poses.
+ */
+struct Trajectory {
+    FixedOdometry fixed;
+    RobotOdometry reference;
+    int16_t left = 0;
+    int16_t right = 0;
+
+    void drive(int16_t leftPerFrame, int16_t rightPerFrame, uint16_t frames) {
+        for (uint16_t i = 0; i < frames; i++) {
+            left += leftPerFrame;
+            right += rightPerFrame;
+            fixed.update(left, right);
+            reference.update(left, right);
+        }
+    }
+
+    void check() {
+        TEST_ASSERT_FLOAT_WITHIN(POSITION_TOLERANCE, reference.getX(), fixed.getX());
+        TEST_ASSERT_FLOAT_WITHIN(POSITION_TOLERANCE, reference.getY(), fixed.getY());
+        TEST_ASSERT_FLOAT_WITHIN(THETA_TOLERANCE, 0.0f, angleDifference(fixed.getTheta(), reference.getTheta()));
+    }
+};
+
+void test_straight_line(void) {
+    Trajectory trajectory;
+    trajectory.drive(12, 12, 500);
+    trajectory.check();
+
+    // 6000 ticks straight ahead: all x, no y or heading.
+    TEST_ASSERT_FLOAT_WITHIN(POSITION_TOLERANCE, 6000 * (M_PI * 32) / 358.3, trajectory.fixed.getX());
+    TEST_ASSERT_FLOAT_WITHIN(POSITION_TOLERANCE, 0.0f, trajectory.fixed.getY());
+    TEST_ASSERT_EQUAL_UINT16(0, trajectory.fixed.getHeading());
+}
+
+void test_left_arc(void) {
+    Trajectory trajectory;
+    trajectory.drive(9, 13, 50);
+    trajectory.check();
+
+    // Left turns are counter-clockwise and drive y negative.
+    TEST_ASSERT_TRUE(trajectory.fixed.getTheta() > 0.0);
+    TEST_ASSERT_TRUE(trajectory.fixed.getY() < 0.0);
+
+    // Once round and a bit.
+    trajectory.drive(9, 13, 400);
+    trajectory.check();
+}
+
+void test_right_arc_past_half_a_turn(void) {
+    Trajectory trajectory;
+    trajectory.drive(14, 8, 600);
+    trajectory.check();
+}
+
+void test_spin_in_place_keeps_position(void) {
+    Trajectory trajectory;
+    trajectory.drive(-10, 10, 300);
+    trajectory.check();
+
+    TEST_ASSERT_FLOAT_WITHIN(POSITION_TOLERANCE, 0.0f, trajectory.fixed.getX());
+    TEST_ASSERT_FLOAT_WITHIN(POSITION_TOLERANCE, 0.0f, trajectory.fixed.getY());
+    TEST_ASSERT_EQUAL_INT32(0, trajectory.fixed.getDistanceQ8());
+}
+
+void test_s_curve_with_reversing(void) {
+    Trajectory trajectory;
+    trajectory.drive(12, 12, 100);
+    trajectory.drive(8, 14, 150);
+    trajectory.drive(14, 8, 150);
+    trajectory.drive(-6, -6, 80);
+    trajectory.drive(10, 11, 200);
+    trajectory.check();
+}
+
+void test_counts_wrapping_around_16_bits(void) {
+    // 40 ticks per frame for 1000 frames passes 32767 and wraps negative.
+    Trajectory trajectory;
+    trajectory.drive(40, 41, 1000);
+    TEST_ASSERT_TRUE(trajectory.left < 0);
+    trajectory.check();
+
+    // The distance keeps counting up through the wrap.
+    const double ticks = (40.0 + 41.0) / 2.0 * 1000;
+    TEST_ASSERT_FLOAT_WITHIN(POSITION_TOLERANCE, ticks * (M_PI * 32) / 358.3,
+                             FixedOdometry::toMillimetres(trajectory.fixed.getDistanceQ8()));
+}
+
+void test_reset_ignores_earlier_ticks(void) {
+    // Calibration spin and an earlier run, before this run's reset().
+    HostEncoders::turnWheels(-4000, 4000);
+    HostEncoders::turnWheels(9000, 9400);
+
+    FixedOdometry odometry;
+    odometry.reset();
+    odometry.update();
+    TEST_ASSERT_EQUAL_INT32(0, odometry.getDistanceQ8());
+    TEST_ASSERT_EQUAL_INT32(0, odometry.getXQ8());
+    TEST_ASSERT_EQUAL_INT32(0, odometry.getYQ8());
+    TEST_ASSERT_EQUAL_UINT16(0, odometry.getHeading());
+
+    for (int i = 0; i < 40; i++) {
+        HostEncoders::turnWheels(10, 10);
+        odometry.update();
+    }
+    TEST_ASSERT_FLOAT_WITHIN(POSITION_TOLERANCE, 400 * MM_PER_TICK,
+                             FixedOdometry::toMillimetres(odometry.getDistanceQ8()));
+    TEST_ASSERT_FLOAT_WITHIN(POSITION_TOLERANCE, 400 * MM_PER_TICK, odometry.getX());
+    TEST_ASSERT_FLOAT_WITHIN(POSITION_TOLERANCE, 0.0f, odometry.getY());
+
+    // The next run starts from 0 again, wherever the counts are.
+    HostEncoders::turnWheels(-300, 300);
+    odometry.reset();
+    HostEncoders::turnWheels(20, 20);
+    odometry.update();
+    TEST_ASSERT_FLOAT_WITHIN(POSITION_TOLERANCE, 20 * MM_PER_TICK,
+                             FixedOdometry::toMillimetres(odometry.getDistanceQ8()));
+}
+
+void test_snapshot_path_matches_the_reference(void) {
+    HostEncoders::turnWheels(1234, -567);
+
+    FixedOdometry odometry;
+    RobotOdometry reference;
+    odometry.reset();
+    int16_t left = 0;
+    int16_t right = 0;
+    const int16_t legs[][3] = {{12, 12, 100}, {9, 13, 150}, {14, 8, 200}, {-6, -6, 50}};
+    for (const int16_t *leg : legs) {
+        for (int16_t i = 0; i < leg[2]; i++) {
+            HostEncoders::turnWheels(leg[0], leg[1]);
+            odometry.update();
+            left += leg[0];
+            right += leg[1];
+            reference.update(left, right);
+        }
+    }
+
+    // Each frame rounds its displacement to Q8 (up to 1/512 mm), and the
+    // heading wiggles by a tick between the two wheels' edges: 500 frames
+    // drift further than the frame-level path.
+    TEST_ASSERT_FLOAT_WITHIN(5 * POSITION_TOLERANCE, reference.getX(), odometry.getX());
+    TEST_ASSERT_FLOAT_WITHIN(5 * POSITION_TOLERANCE, reference.getY(), odometry.getY());
+    TEST_ASSERT_FLOAT_WITHIN(THETA_TOLERANCE, 0.0f, angleDifference(odometry.getTheta(), reference.getTheta()));
+    TEST_ASSERT_FLOAT_WITHIN(5 * POSITION_TOLERANCE, (100 * 12 + 150 * 11 + 200 * 11 - 50 * 6) * MM_PER_TICK,
+                             FixedOdometry::toMillimetres(odometry.getDistanceQ8()));
+}
+
+void test_gyro_bias_is_learned_only_with_the_wheels_stopped(void) {
+    FixedOdometry odometry;
+    odometry.reset();
+
+    // Straight ahead, the encoder heading holds still but the wheels turn.
+    for (int i = 0; i < 400; i++) {
+        HostEncoders::micros += 10000;
+        HostEncoders::turnWheels(10, 10);
+        odometry.update(30);
+    }
+    TEST_ASSERT_EQUAL_INT32(0, odometry.getHeadingFilter().getBias());
+
+    for (int i = 0; i < 400; i++) {
+        HostEncoders::micros += 10000;
+        odometry.update(30);
+    }
+    TEST_ASSERT_INT_WITHIN(30 * 256 / 20, 30 * 256, odometry.getHeadingFilter().getBias());
+}
+
+int main(int argc, char **argv) {
+    (void) argc;
+    (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_straight_line);
+    RUN_TEST(test_left_arc);
+    RUN_TEST(test_right_arc_past_half_a_turn);
+    RUN_TEST(test_spin_in_place_keeps_position);
+    RUN_TEST(test_s_curve_with_reversing);
+    RUN_TEST(test_counts_wrapping_around_16_bits);
+    RUN_TEST(test_reset_ignores_earlier_ticks);
+    RUN_TEST(test_snapshot_path_matches_the_reference);
+    RUN_TEST(test_gyro_bias_is_learned_only_with_the_wheels_stopped);
+    return UNITY_END();
+}
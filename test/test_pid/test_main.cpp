@@ -0,0 +1,165 @@
+/*
+ * File: test_main.cpp
+ *
+ * Description:
+ * Host unit tests for `PidController`: the response to the same step at
+ * frame times of 5, 10 and 30 ms, the derivative filter settling on a
+ * ramp, integral anti-windup, and reset() / PID_MAX_DT restarts.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include <unity.h>
+#include "PidController.h"
+
+static const microseconds frameTimes[] = {5000, 10000, 30000};
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_first_update_only_primes(void) {
+    PidController pid(256, 0, 256, 0, 1000);
+    TEST_ASSERT_EQUAL_INT16(50, pid.update(0, 50, PID_NOMINAL_DT));
+    TEST_ASSERT_EQUAL_INT32(0, pid.getDerivative());
+}
+
+void test_proportional_step_does_not_depend_on_dt(void) {
+    for (microseconds dt : frameTimes) {
+        PidController pid(256, 0, 0, 0, 1000);
+        pid.update(0, 0, dt);
+        TEST_ASSERT_EQUAL_INT16(100, pid.update(0, 100, dt));
+    }
+}
+
+void test_derivative_step_scales_with_inverse_dt(void) {
+    for (microseconds dt : frameTimes) {
+        PidController pid(0, 0, 256, 0, 1000);
+        pid.update(0, 0, dt);
+        // kd = 1 per nominal frame: a step of 100 in one nominal frame gives 100.
+        const int16_t expected = 100L * PID_NOMINAL_DT / dt;
+        TEST_ASSERT_INT_WITHIN(1, expected, pid.update(0, 100, dt));
+    }
+}
+
+void test_filtered_step_decays_and_settles(void) {
+    for (microseconds dt : frameTimes) {
+        PidController pid(0, 0, 256, DERIVATIVE_FILTER_TIME, 1000);
+        pid.update(0, 0, dt);
+        const int16_t unfiltered = 100L * PID_NOMINAL_DT / dt;
+        int16_t previous = pid.update(0, 100, dt);
+        TEST_ASSERT_GREATER_THAN(0, previous);
+        TEST_ASSERT_LESS_THAN(unfiltered, previous);
+
+        // The measurement holds still: the derivative decays monotonically to 0.
+        for (int i = 0; i < 40; i++) {
+            const int16_t output = pid.update(0, 100, dt);
+            TEST_ASSERT_LESS_OR_EQUAL(previous, output);
+            previous = output;
+        }
+        TEST_ASSERT_EQUAL_INT16(0, previous);
+    }
+}
+
+void test_filtered_ramp_settles_to_the_same_rate_at_any_dt(void) {
+    for (microseconds dt : frameTimes) {
+        PidController pid(0, 0, 256, DERIVATIVE_FILTER_TIME, 1000);
+        // 8 units per ms, i.e. 80 per nominal frame whatever the frame time.
+        int32_t measurement = 0;
+        int16_t output = 0;
+        for (int i = 0; i < 60; i++) {
+            output = pid.update(0, measurement, dt);
+            measurement += 8L * dt / 1000;
+        }
+        TEST_ASSERT_INT_WITHIN(2, 80, output);
+    }
+}
+
+void test_integral_scales_with_dt(void) {
+    for (microseconds dt : frameTimes) {
+        PidController pid(0, 256, 0, 0, 30000);
+        pid.update(0, 10, dt);
+        // ki = 1 per nominal frame: 10 per nominal frame of error 10.
+        pid.update(0, 10, dt);
+        TEST_ASSERT_INT_WITHIN(256, 10L * 256 * dt / PID_NOMINAL_DT, pid.getIntegral());
+    }
+}
+
+void test_anti_windup_clamps_the_integral(void) {
+    PidController pid(64, 128, 0, 0, 50);
+    pid.update(0, 400, PID_NOMINAL_DT);
+    for (int i = 0; i < 200; i++) {
+        TEST_ASSERT_EQUAL_INT16(50, pid.update(0, 400, PID_NOMINAL_DT));
+        TEST_ASSERT_LESS_OR_EQUAL(50L << 8, pid.getIntegral());
+    }
+
+    // Saturated by P alone, the integral never grew; the output follows the
+    // error back at once.
+    TEST_ASSERT_EQUAL_INT32(0, pid.getIntegral());
+    TEST_ASSERT_EQUAL_INT16(-25, pid.update(0, -100, PID_NOMINAL_DT));
+}
+
+void test_integral_stops_at_the_limit(void) {
+    PidController pid(0, 256, 0, 0, 50);
+    pid.update(0, 20, PID_NOMINAL_DT);
+    for (int i = 0; i < 100; i++) {
+        pid.update(0, 20, PID_NOMINAL_DT);
+        TEST_ASSERT_LESS_OR_EQUAL(50L << 8, pid.getIntegral());
+    }
+    TEST_ASSERT_EQUAL_INT32(50L << 8, pid.getIntegral());
+
+    // One frame of opposite error brings it straight out of saturation.
+    pid.update(0, -20, PID_NOMINAL_DT);
+    TEST_ASSERT_LESS_THAN(50L << 8, pid.getIntegral());
+}
+
+void test_reset_clears_integral_and_derivative(void) {
+    PidController pid(0, 256, 256, DERIVATIVE_FILTER_TIME, 1000);
+    pid.update(0, 0, PID_NOMINAL_DT);
+    pid.update(0, 100, PID_NOMINAL_DT);
+    pid.update(0, 100, PID_NOMINAL_DT);
+    TEST_ASSERT_NOT_EQUAL(0, pid.getIntegral());
+    TEST_ASSERT_NOT_EQUAL(0, pid.getDerivative());
+
+    pid.reset();
+    TEST_ASSERT_EQUAL_INT32(0, pid.getIntegral());
+    TEST_ASSERT_EQUAL_INT32(0, pid.getDerivative());
+
+    // The next update primes: a jump from the old measurement is no derivative.
+    TEST_ASSERT_EQUAL_INT16(0, pid.update(0, -300, PID_NOMINAL_DT));
+    TEST_ASSERT_EQUAL_INT32(0, pid.getDerivative());
+}
+
+void test_long_gap_restarts_the_derivative(void) {
+    PidController pid(0, 256, 256, 0, 1000);
+    pid.update(0, 10, PID_NOMINAL_DT);
+    pid.update(0, 10, PID_NOMINAL_DT);
+    const int32_t integral = pid.getIntegral();
+
+    // After a gap longer than PID_MAX_DT, only the integral is kept.
+    TEST_ASSERT_EQUAL_INT16(integral >> 8, pid.update(0, 500, PID_MAX_DT + 1));
+    TEST_ASSERT_EQUAL_INT32(0, pid.getDerivative());
+    TEST_ASSERT_EQUAL_INT32(integral, pid.getIntegral());
+
+    // The derivative then restarts from the measurement at the gap.
+    pid.update(0, 510, PID_NOMINAL_DT);
+    TEST_ASSERT_EQUAL_INT32(10 << 4, pid.getDerivative());
+}
+
+int main(int argc, char **argv) {
+    (void) argc;
+    (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_first_update_only_primes);
+    RUN_TEST(test_proportional_step_does_not_depend_on_dt);
+    RUN_TEST(test_derivative_step_scales_with_inverse_dt);
+    RUN_TEST(test_filtered_step_decays_and_settles);
+    RUN_TEST(test_filtered_ramp_settles_to_the_same_rate_at_any_dt);
+    RUN_TEST(test_integral_scales_with_dt);
+    RUN_TEST(test_anti_windup_clamps_the_integral);
+    RUN_TEST(test_integral_stops_at_the_limit);
+    RUN_TEST(test_reset_clears_integral_and_derivative);
+    RUN_TEST(test_long_gap_restarts_the_derivative);
+    return UNITY_END();
+}
@@ -0,0 +1,243 @@
+/*
+ * File: test_main.cpp
+ *
+ * Description:
+ * Host unit tests for `TaskPriorityLinkedList` and for `EventManager`
+ * built on it (EVENT_LINKED_LIST set): no duplicate queueing, priority
+ * order with FIFO among equals, popping the head, removal, and the
+ * manager's dispatch order, budget, cancellation and timers.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include <unity.h>
+#include "RATS.h"
+
+// Build the manager on the linked list, whatever the firmware default is.
+#undef EVENT_LINKED_LIST
+#define EVENT_LINKED_LIST 1
+#undef EVENT_TRACE
+#define EVENT_TRACE 0
+
+#include "TaskPriorityLinkedList.h"
+#include "EventManager.h"
+
+typedef enum TestTask {
+    First,
+    Second,
+    Third,
+    Fourth,
+    NUMBER_OF_TEST_TASKS
+} TestTask;
+
+typedef void (*TestCallback)(TestTask task);
+typedef TaskPriorityLinkedList<TestTask, TestCallback, NUMBER_OF_TEST_TASKS> TestList;
+
+// Order in which callbacks ran, for both the list and the manager.
+static uint8_t ran[16];
+static uint8_t ranCount = 0;
+
+static void recordTask(TestTask task) {
+    ran[ranCount++] = task;
+}
+
+static void recordEvent(Event event) {
+    ran[ranCount++] = event;
+}
+
+void setUp(void) {
+    ranCount = 0;
+}
+
+void tearDown(void) {}
+
+static TestTask popTask(TestList &list) {
+    Option<TestTask> popped = list.pop();
+    TEST_ASSERT_TRUE(popped.exists());
+    return popped.get();
+}
+
+void test_fire_twice_queues_once(void) {
+    TestList list;
+    list.fire(Second);
+    list.fire(Second);
+    TEST_ASSERT_EQUAL_UINT8(1, list.size());
+    TEST_ASSERT_EQUAL(Second, popTask(list));
+    TEST_ASSERT_FALSE(list.pop().exists());
+
+    // Once popped, it can be queued again.
+    list.fire(Second);
+    TEST_ASSERT_TRUE(list.isQueued(Second));
+}
+
+void test_fire_inserts_by_priority_fifo_among_equals(void) {
+    TestList list;
+    list.setUpTask(First, recordTask, 2);
+    list.setUpTask(Second, recordTask, 0);
+    list.setUpTask(Third, recordTask, 2);
+    list.setUpTask(Fourth, recordTask, 1);
+
+    list.fire(First);
+    list.fire(Second);
+    list.fire(Third);
+    list.fire(Fourth);
+
+    TEST_ASSERT_EQUAL(Second, popTask(list));
+    TEST_ASSERT_EQUAL(Fourth, popTask(list));
+    TEST_ASSERT_EQUAL(First, popTask(list));
+    TEST_ASSERT_EQUAL(Third, popTask(list));
+    TEST_ASSERT_EQUAL_UINT8(0, list.size());
+}
+
+void test_pop_takes_the_head_and_keeps_the_rest_linked(void) {
+    TestList list;
+    for (uint8_t i = 0; i < NUMBER_OF_TEST_TASKS; i++) {
+        list.setUpTask(TestTask(i), recordTask, 0);
+        list.fire(TestTask(i));
+    }
+    for (uint8_t i = 0; i < NUMBER_OF_TEST_TASKS; i++) {
+        TEST_ASSERT_EQUAL_UINT8(NUMBER_OF_TEST_TASKS - i, list.size());
+        TEST_ASSERT_EQUAL(i, popTask(list));
+        TEST_ASSERT_FALSE(list.isQueued(TestTask(i)));
+    }
+    TEST_ASSERT_FALSE(list.pop().exists());
+}
+
+void test_remove_unlinks_from_anywhere(void) {
+    TestList list;
+    list.fire(First);
+    list.fire(Second);
+    list.fire(Third);
+
+    list.remove(Second);
+    list.remove(Second);
+    list.remove(Fourth);
+
+    TEST_ASSERT_EQUAL_UINT8(2, list.size());
+    TEST_ASSERT_EQUAL(First, popTask(list));
+    TEST_ASSERT_EQUAL(Third, popTask(list));
+}
+
+void test_run_next_calls_the_task(void) {
+    TestList list;
+    list.setUpTask(Third, recordTask, 0);
+    list.fire(Third);
+    list.fire(Fourth); // No task set up: popped without a call.
+
+    TEST_ASSERT_TRUE(list.runNext());
+    TEST_ASSERT_TRUE(list.runNext());
+    TEST_ASSERT_FALSE(list.runNext());
+    TEST_ASSERT_EQUAL_UINT8(1, ranCount);
+    TEST_ASSERT_EQUAL(Third, ran[0]);
+}
+
+void test_reset_empties_but_keeps_tasks(void) {
+    TestList list;
+    list.setUpTask(First, recordTask, 0);
+    list.fire(First);
+    list.fire(Second);
+    list.reset();
+    TEST_ASSERT_EQUAL_UINT8(0, list.size());
+    TEST_ASSERT_FALSE(list.isQueued(First));
+
+    list.fire(First);
+    TEST_ASSERT_TRUE(list.runNext());
+    TEST_ASSERT_EQUAL_UINT8(1, ranCount);
+}
+
+void test_manager_dispatches_urgent_first_then_in_firing_order(void) {
+    EventManager manager;
+    manager.setupListener(SlowDown, recordEvent);
+    manager.setupListener(SpeedUp, recordEvent);
+    manager.setupListener(Measured, recordEvent, Urgent);
+
+    manager.fireEvent(SpeedUp);
+    manager.fireEvent(SlowDown);
+    manager.fireEvent(SpeedUp);
+    manager.fireEvent(Measured);
+
+    TEST_ASSERT_EQUAL_UINT8(3, manager.dispatch(10));
+    TEST_ASSERT_EQUAL_UINT8(3, ranCount);
+    TEST_ASSERT_EQUAL(Measured, ran[0]);
+    TEST_ASSERT_EQUAL(SpeedUp, ran[1]);
+    TEST_ASSERT_EQUAL(SlowDown, ran[2]);
+}
+
+void test_manager_budget_and_cancel(void) {
+    EventManager manager;
+    manager.setupListener(SlowDown, recordEvent);
+    manager.setupListener(SpeedUp, recordEvent);
+    manager.setupListener(TurnLeft, recordEvent);
+
+    manager.fireEvent(SlowDown);
+    manager.fireEvent(SpeedUp);
+    manager.fireEvent(TurnLeft);
+    manager.cancel(SpeedUp);
+    TEST_ASSERT_FALSE(manager.isPending(SpeedUp));
+
+    TEST_ASSERT_EQUAL_UINT8(1, manager.dispatch(1));
+    TEST_ASSERT_TRUE(manager.isPending(TurnLeft));
+    TEST_ASSERT_EQUAL_UINT8(1, manager.dispatch(5));
+    TEST_ASSERT_EQUAL_UINT8(0, manager.dispatch(5));
+    TEST_ASSERT_EQUAL_UINT8(2, ranCount);
+    TEST_ASSERT_EQUAL(SlowDown, ran[0]);
+    TEST_ASSERT_EQUAL(TurnLeft, ran[1]);
+}
+
+static EventManager *chained = nullptr;
+
+static void refire(Event event) {
+    recordEvent(event);
+    chained->fireEvent(SpeedUp);
+}
+
+void test_manager_events_fired_by_callbacks_wait_for_the_next_dispatch(void) {
+    EventManager manager;
+    chained = &manager;
+    manager.setupListener(SlowDown, refire);
+    manager.setupListener(SpeedUp, recordEvent);
+
+    manager.fireEvent(SlowDown);
+    TEST_ASSERT_EQUAL_UINT8(1, manager.dispatch(10));
+    TEST_ASSERT_TRUE(manager.isPending(SpeedUp));
+    TEST_ASSERT_EQUAL_UINT8(1, manager.dispatch(10));
+    TEST_ASSERT_EQUAL(SpeedUp, ran[1]);
+}
+
+void test_manager_timers_and_distance_fire_through_the_list(void) {
+    EventManager manager;
+    manager.setupListener(Reached5cm, recordEvent);
+    manager.setupListener(SpeedUp, recordEvent);
+
+    manager.advance(1000, 0);
+    manager.fireEventAfter(SpeedUp, 20);
+    manager.fireAtDistance(Reached5cm, 50);
+
+    manager.advance(15000, 40L << 8);
+    TEST_ASSERT_EQUAL_UINT8(0, manager.dispatch(10));
+
+    manager.advance(30000, 50L << 8);
+    TEST_ASSERT_TRUE(manager.isPending(Reached5cm));
+    TEST_ASSERT_TRUE(manager.isPending(SpeedUp));
+    TEST_ASSERT_EQUAL_UINT8(2, manager.dispatch(10));
+    TEST_ASSERT_EQUAL(Reached5cm, ran[0]);
+    TEST_ASSERT_EQUAL(SpeedUp, ran[1]);
+}
+
+int main(int argc, char **argv) {
+    (void) argc;
+    (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_fire_twice_queues_once);
+    RUN_TEST(test_fire_inserts_by_priority_fifo_among_equals);
+    RUN_TEST(test_pop_takes_the_head_and_keeps_the_rest_linked);
+    RUN_TEST(test_remove_unlinks_from_anywhere);
+    RUN_TEST(test_run_next_calls_the_task);
+    RUN_TEST(test_reset_empties_but_keeps_tasks);
+    RUN_TEST(test_manager_dispatches_urgent_first_then_in_firing_order);
+    RUN_TEST(test_manager_budget_and_cancel);
+    RUN_TEST(test_manager_events_fired_by_callbacks_wait_for_the_next_dispatch);
+    RUN_TEST(test_manager_timers_and_distance_fire_through_the_list);
+    return UNITY_END();
+}
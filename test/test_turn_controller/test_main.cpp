@@ -0,0 +1,171 @@
+/*
+ * File: test_main.cpp
+ *
+ * Description:
+ * Host unit tests for `TurnController`. A simulated robot spins at the
+ * speed each step() returns, so the tests follow the heading through
+ * left and right turns, turns across the ±180 degree wrap and whole
+ * turns, checking that they stop within a frame of the target and slow
+ * down on the way in. The line window and finish() are covered too.
+ *
+ * Author: agent
+ * Version: 2026-10-18
+ */
+
+#include <unity.h>
+#include "TurnController.h"
+
+static const double FRAME_S = 0.01;      // Simulated frame period (s).
+static const uint16_t MAX_FRAMES = 1000;
+
+/*
+ * Heading change (65536 per turn) of one frame spinning at a wheel speed
+ * (mm/s): each wheel runs on a circle of half the wheel distance.
+ */
+static double spinPerFrame(int16_t speed) {
+    return 2.0 * speed * FRAME_S / WHEEL_DISTANCE * 65536.0 / (2.0 * M_PI);
+}
+
+/*
+ * A robot spinning in place under a TurnController.
+ */
+struct SpinningRobot {
+    TurnController turn;
+    double heading;                      // Simulated heading (65536 per turn, unwrapped).
+    double turned = 0;                   // Angle turned since the start.
+    uint16_t frames = 0;
+    int16_t speeds[MAX_FRAMES];
+
+    SpinningRobot(FixedTrig::BinaryAngle start, int32_t angle) : heading(start) {
+        turn.begin(start, angle);
+    }
+
+    FixedTrig::BinaryAngle sensed() const {
+        return static_cast<FixedTrig::BinaryAngle>(static_cast<int64_t>(llround(heading)));
+    }
+
+    /*
+     * Steps until the controller stops the wheels.
+     */
+    void run() {
+        for (;;) {
+            const int16_t speed = turn.step(sensed());
+            if (speed == 0) {
+                return;
+            }
+            TEST_ASSERT_TRUE(frames < MAX_FRAMES);
+            speeds[frames++] = speed;
+            heading += spinPerFrame(speed);
+            turned += spinPerFrame(speed);
+        }
+    }
+};
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_starts_idle(void) {
+    TurnController turn;
+    TEST_ASSERT_TRUE(turn.isDone());
+    TEST_ASSERT_EQUAL_INT16(0, turn.step(1234));
+}
+
+void test_left_turn_stops_within_a_frame_of_the_target(void) {
+    SpinningRobot robot(0, TURN_ANGLE_90);
+    robot.run();
+    TEST_ASSERT_TRUE(robot.turn.isDone());
+    TEST_ASSERT_FLOAT_WITHIN(spinPerFrame(TURN_MIN_SPEED), TURN_ANGLE_90, robot.turned);
+
+    // Full speed first, counter-clockwise throughout.
+    TEST_ASSERT_EQUAL_INT16(TURN_MAX_SPEED, robot.speeds[0]);
+    for (uint16_t i = 0; i < robot.frames; i++) {
+        TEST_ASSERT_TRUE(robot.speeds[i] >= TURN_MIN_SPEED);
+        TEST_ASSERT_TRUE(robot.speeds[i] <= TURN_MAX_SPEED);
+    }
+}
+
+void test_speed_only_falls_on_the_way_in(void) {
+    SpinningRobot robot(0, TURN_ANGLE_180);
+    robot.run();
+    TEST_ASSERT_TRUE(robot.frames > 2);
+    for (uint16_t i = 1; i < robot.frames; i++) {
+        TEST_ASSERT_TRUE(robot.speeds[i] <= robot.speeds[i - 1]);
+    }
+    TEST_ASSERT_TRUE(robot.speeds[robot.frames - 1] < TURN_MAX_SPEED);
+    TEST_ASSERT_FLOAT_WITHIN(spinPerFrame(TURN_MIN_SPEED), TURN_ANGLE_180, robot.turned);
+}
+
+void test_right_turn_spins_clockwise(void) {
+    SpinningRobot robot(5000, -TURN_ANGLE_90);
+    robot.run();
+    TEST_ASSERT_EQUAL_INT16(-TURN_MAX_SPEED, robot.speeds[0]);
+    for (uint16_t i = 0; i < robot.frames; i++) {
+        TEST_ASSERT_TRUE(robot.speeds[i] < 0);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(spinPerFrame(TURN_MIN_SPEED), -TURN_ANGLE_90, robot.turned);
+}
+
+void test_turns_across_the_wrap(void) {
+    // From just short of +180 degrees through -180 and on.
+    SpinningRobot left(30000, TURN_ANGLE_90);
+    left.run();
+    TEST_ASSERT_FLOAT_WITHIN(spinPerFrame(TURN_MIN_SPEED), TURN_ANGLE_90, left.turned);
+
+    SpinningRobot right(-30000, -TURN_ANGLE_90);
+    right.run();
+    TEST_ASSERT_FLOAT_WITHIN(spinPerFrame(TURN_MIN_SPEED), -TURN_ANGLE_90, right.turned);
+}
+
+void test_whole_turn_is_tracked_past_the_start_heading(void) {
+    SpinningRobot robot(1000, 2 * TURN_ANGLE_180 + TURN_ANGLE_90);
+    robot.run();
+    TEST_ASSERT_FLOAT_WITHIN(spinPerFrame(TURN_MIN_SPEED), 2 * TURN_ANGLE_180 + TURN_ANGLE_90, robot.turned);
+}
+
+void test_line_window_opens_near_the_target(void) {
+    TurnController turn;
+    turn.begin(0, TURN_ANGLE_90);
+    TEST_ASSERT_FALSE(turn.inLineWindow());
+
+    turn.step(TURN_ANGLE_90 - TURN_LINE_WINDOW - 10);
+    TEST_ASSERT_FALSE(turn.inLineWindow());
+
+    turn.step(TURN_ANGLE_90 - TURN_LINE_WINDOW + 10);
+    TEST_ASSERT_TRUE(turn.inLineWindow());
+    TEST_ASSERT_FALSE(turn.isDone());
+}
+
+void test_finish_ends_the_turn_early(void) {
+    TurnController turn;
+    turn.begin(0, TURN_ANGLE_180);
+    TEST_ASSERT_NOT_EQUAL(0, turn.step(100));
+
+    turn.finish();
+    TEST_ASSERT_TRUE(turn.isDone());
+    TEST_ASSERT_EQUAL_INT16(0, turn.step(200));
+    TEST_ASSERT_EQUAL_INT32(TURN_ANGLE_180 - 200, turn.getRemaining());
+}
+
+void test_overshoot_ends_the_turn(void) {
+    TurnController turn;
+    turn.begin(0, TURN_ANGLE_90);
+    turn.step(TURN_ANGLE_90 + 2 * TURN_TOLERANCE);
+    TEST_ASSERT_TRUE(turn.isDone());
+}
+
+int main(int argc, char **argv) {
+    (void) argc;
+    (void) argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_starts_idle);
+    RUN_TEST(test_left_turn_stops_within_a_frame_of_the_target);
+    RUN_TEST(test_speed_only_falls_on_the_way_in);
+    RUN_TEST(test_right_turn_spins_clockwise);
+    RUN_TEST(test_turns_across_the_wrap);
+    RUN_TEST(test_whole_turn_is_tracked_past_the_start_heading);
+    RUN_TEST(test_line_window_opens_near_the_target);
+    RUN_TEST(test_finish_ends_the_turn_early);
+    RUN_TEST(test_overshoot_ends_the_turn);
+    return UNITY_END();
+}